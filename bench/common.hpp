@@ -0,0 +1,48 @@
+#ifndef YACS_BENCH_COMMON_H
+#define YACS_BENCH_COMMON_H
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+typedef struct float3 {
+  float3() : x(0.f), y(0.f), z(0.f) {}
+  float3(float x, float y, float z) : x(x), y(y), z(z) {}
+  float x;
+  float y;
+  float z;
+} float3;
+
+typedef struct position : float3 {
+  using float3::float3;
+} position;
+
+typedef struct velocity : float3 {
+  using float3::float3;
+} velocity;
+
+typedef struct mass {
+  mass() : value(1.f) {}
+  mass(float value) : value(value) {}
+  float value;
+} mass;
+
+inline void entity_counts(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t n = 1000; n <= 10000000; n *= 10) {
+    benchmark->Arg(n);
+  }
+  benchmark->Unit(benchmark::kMicrosecond);
+}
+
+inline std::vector<size_t> shuffled_indices(size_t n, uint32_t seed = 42) {
+  std::vector<size_t> indices(n);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::shuffle(indices.begin(), indices.end(), std::mt19937(seed));
+  return indices;
+}
+
+#endif
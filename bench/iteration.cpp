@@ -0,0 +1,214 @@
+#include <memory>
+
+#include "archetype_registry.hpp"
+#include "basic_registry.hpp"
+#include "common.hpp"
+#include "entity.hpp"
+#include "registry.hpp"
+#include "view.hpp"
+
+class iteration_fixture : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State& state) override {
+    n = static_cast<size_t>(state.range(0));
+    positions = std::make_unique<yacs::packed_pool<position>>();
+    velocities = std::make_unique<yacs::packed_pool<velocity>>();
+    masses = std::make_unique<yacs::packed_pool<mass>>();
+    for (auto index : shuffled_indices(n)) {
+      positions->construct(index, 0.f, 0.f, 0.f);
+      if (index % 2 == 0) {
+        velocities->construct(index, 1.f, 1.f, 1.f);
+      }
+      if (index % 4 == 0) {
+        masses->construct(index, 2.f);
+      }
+    }
+  }
+
+  void TearDown(const benchmark::State&) override {
+    positions.reset();
+    velocities.reset();
+    masses.reset();
+  }
+
+  size_t n;
+  std::unique_ptr<yacs::packed_pool<position>> positions;
+  std::unique_ptr<yacs::packed_pool<velocity>> velocities;
+  std::unique_ptr<yacs::packed_pool<mass>> masses;
+};
+
+BENCHMARK_DEFINE_F(iteration_fixture, manual_lookup)(benchmark::State& state) {
+  for (auto _ : state) {
+    auto index = positions->sparse_begin();
+    for (auto& p : *positions) {
+      auto sparse_index = *index++;
+      if (!velocities->contains(sparse_index) ||
+          !masses->contains(sparse_index)) {
+        continue;
+      }
+      auto& v = velocities->access(sparse_index);
+      auto& m = masses->access(sparse_index);
+      p.x += v.x * m.value;
+      p.y += v.y * m.value;
+      p.z += v.z * m.value;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_REGISTER_F(iteration_fixture, manual_lookup)->Apply(entity_counts);
+
+BENCHMARK_DEFINE_F(iteration_fixture, view_each)(benchmark::State& state) {
+  yacs::view<position, const velocity, const mass> view(*positions,
+                                                        *velocities, *masses);
+  for (auto _ : state) {
+    view.each([](position& p, const velocity& v, const mass& m) {
+      p.x += v.x * m.value;
+      p.y += v.y * m.value;
+      p.z += v.z * m.value;
+    });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_REGISTER_F(iteration_fixture, view_each)->Apply(entity_counts);
+
+BENCHMARK_DEFINE_F(iteration_fixture, view_range)(benchmark::State& state) {
+  yacs::view<position, const velocity, const mass> view(*positions,
+                                                        *velocities, *masses);
+  for (auto _ : state) {
+    for (auto [p, v, m] : view) {
+      p.x += v.x * m.value;
+      p.y += v.y * m.value;
+      p.z += v.z * m.value;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_REGISTER_F(iteration_fixture, view_range)->Apply(entity_counts);
+
+static void group_each(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  yacs::registry registry;
+  for (size_t i = 0; i < n; ++i) {
+    auto id = yacs::get_entity_id(i, 0);
+    registry.create();
+    registry.add<position>(id, 0.f, 0.f, 0.f);
+    if (i % 2 == 0) {
+      registry.add<velocity>(id, 1.f, 1.f, 1.f);
+    }
+    if (i % 4 == 0) {
+      registry.add<mass>(id, 2.f);
+    }
+  }
+  auto group = registry.group<position, velocity, mass>();
+  for (auto _ : state) {
+    group.each([](position& p, velocity& v, mass& m) {
+      p.x += v.x * m.value;
+      p.y += v.y * m.value;
+      p.z += v.z * m.value;
+    });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(group_each)->Apply(entity_counts);
+
+static void archetype_each(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  yacs::archetype_registry registry;
+  for (size_t i = 0; i < n; ++i) {
+    auto id = registry.create();
+    registry.add<position>(id, 0.f, 0.f, 0.f);
+    if (i % 2 == 0) {
+      registry.add<velocity>(id, 1.f, 1.f, 1.f);
+    }
+    if (i % 4 == 0) {
+      registry.add<mass>(id, 2.f);
+    }
+  }
+  for (auto _ : state) {
+    registry.each<position, const velocity, const mass>(
+        [](position& p, const velocity& v, const mass& m) {
+          p.x += v.x * m.value;
+          p.y += v.y * m.value;
+          p.z += v.z * m.value;
+        });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(archetype_each)->Apply(entity_counts);
+
+template <typename Registry>
+static void registry_view_each(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  Registry registry;
+  for (size_t i = 0; i < n; ++i) {
+    auto id = yacs::get_entity_id(i, 0);
+    registry.create();
+    registry.template add<position>(id, 0.f, 0.f, 0.f);
+    if (i % 2 == 0) {
+      registry.template add<velocity>(id, 1.f, 1.f, 1.f);
+    }
+    if (i % 4 == 0) {
+      registry.template add<mass>(id, 2.f);
+    }
+  }
+  for (auto _ : state) {
+    registry.template view<position, const velocity, const mass>().each(
+        [](position& p, const velocity& v, const mass& m) {
+          p.x += v.x * m.value;
+          p.y += v.y * m.value;
+          p.z += v.z * m.value;
+        });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(registry_view_each, yacs::registry)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(registry_view_each,
+                   yacs::basic_registry<position, velocity, mass>)
+    ->Apply(entity_counts);
+
+template <int N>
+struct tag {
+  float value = 0.f;
+};
+
+template <bool Presence>
+static void sparse_join(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  yacs::packed_pool<tag<0>> a;
+  yacs::packed_pool<tag<1>> b;
+  yacs::packed_pool<tag<2>> c;
+  yacs::packed_pool<tag<3>> d;
+  yacs::packed_pool<tag<4>> e;
+  if (Presence) {
+    a.track_presence();
+    b.track_presence();
+    c.track_presence();
+    d.track_presence();
+    e.track_presence();
+  }
+  std::mt19937 random(42);
+  for (auto index : shuffled_indices(n)) {
+    auto bits = random();
+    if (bits & 1) a.construct(index);
+    if (bits & 2) b.construct(index);
+    if (bits & 4) c.construct(index);
+    if (bits & 8) d.construct(index);
+    if (bits & 16) e.construct(index);
+  }
+  yacs::view<tag<0>, tag<1>, tag<2>, tag<3>, tag<4>> view(a, b, c, d, e);
+  for (auto _ : state) {
+    view.each([](tag<0>& ta, tag<1>& tb, tag<2>& tc, tag<3>& td, tag<4>& te) {
+      ta.value += tb.value + tc.value + td.value + te.value;
+    });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(sparse_join, false)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(sparse_join, true)->Apply(entity_counts);
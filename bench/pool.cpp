@@ -0,0 +1,171 @@
+#include "pool.hpp"
+
+#include "common.hpp"
+
+static yacs::packed_pool<position> make_pool(size_t n) {
+  yacs::packed_pool<position> pool;
+  for (size_t i = 0; i < n; ++i) {
+    pool.construct(i, static_cast<float>(i), 0.f, 0.f);
+  }
+  return pool;
+}
+
+static void pool_construct(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    yacs::packed_pool<position> pool;
+    for (size_t i = 0; i < n; ++i) {
+      pool.construct(i, 1.f, 2.f, 3.f);
+    }
+    benchmark::DoNotOptimize(pool.raw());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_construct)->Apply(entity_counts);
+
+static void pool_destroy(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto order = shuffled_indices(n);
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto pool = make_pool(n);
+    state.ResumeTiming();
+    for (auto index : order) {
+      pool.destroy(index);
+    }
+    benchmark::DoNotOptimize(pool.size());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_destroy)->Apply(entity_counts);
+
+static void pool_access(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto pool = make_pool(n);
+  auto order = shuffled_indices(n);
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (auto index : order) {
+      sum += pool.access(index).x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_access)->Apply(entity_counts);
+
+static void pool_value_iteration(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto pool = make_pool(n);
+  for (auto _ : state) {
+    for (auto& p : pool) {
+      p.y += p.x;
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_value_iteration)->Apply(entity_counts);
+
+static void pool_sparse_iteration(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto pool = make_pool(n);
+  for (auto _ : state) {
+    size_t sum = 0;
+    for (auto it = pool.sparse_begin(); it != pool.sparse_end(); ++it) {
+      sum += *it;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_sparse_iteration)->Apply(entity_counts);
+
+static void pool_sort(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto order = shuffled_indices(n);
+  for (auto _ : state) {
+    state.PauseTiming();
+    yacs::packed_pool<position> pool;
+    for (auto index : order) {
+      pool.construct(index, 0.f, 0.f, 0.f);
+    }
+    state.ResumeTiming();
+    pool.sort();
+    benchmark::DoNotOptimize(pool.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_sort)->Apply(entity_counts);
+
+static void pool_sort_comparator(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto order = shuffled_indices(n);
+  for (auto _ : state) {
+    state.PauseTiming();
+    yacs::packed_pool<position> pool;
+    for (size_t i = 0; i < n; ++i) {
+      pool.construct(i, static_cast<float>(order[i]), 0.f, 0.f);
+    }
+    state.ResumeTiming();
+    pool.sort([](const position& lhs, const position& rhs) {
+      return lhs.x < rhs.x;
+    });
+    benchmark::DoNotOptimize(pool.raw());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_sort_comparator)->Apply(entity_counts);
+
+static void pool_sort_by(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto order = shuffled_indices(n);
+  for (auto _ : state) {
+    state.PauseTiming();
+    yacs::packed_pool<position> pool;
+    for (size_t i = 0; i < n; ++i) {
+      pool.construct(i, static_cast<float>(order[i]), 0.f, 0.f);
+    }
+    state.ResumeTiming();
+    pool.sort_by([](const position& value) { return value.x; });
+    benchmark::DoNotOptimize(pool.raw());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_sort_by)->Apply(entity_counts);
+
+static void pool_sort_by_nearly_sorted(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto pool = make_pool(n);
+  auto order = shuffled_indices(n);
+  size_t cursor = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (size_t i = 0; i < n / 100; ++i, cursor = (cursor + 1) % n) {
+      pool.access(order[cursor]).x += 50.f;
+    }
+    state.ResumeTiming();
+    pool.sort_by([](const position& value) { return value.x; });
+    benchmark::DoNotOptimize(pool.raw());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_sort_by_nearly_sorted)->Apply(entity_counts);
+
+static void pool_sort_iterator(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  auto order = shuffled_indices(n);
+  yacs::packed_pool<position> reference;
+  for (auto index : order) {
+    reference.construct(index);
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto pool = make_pool(n);
+    state.ResumeTiming();
+    pool.sort(reference.sparse_begin(), reference.sparse_end());
+    benchmark::DoNotOptimize(pool.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(pool_sort_iterator)->Apply(entity_counts);
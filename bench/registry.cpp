@@ -0,0 +1,419 @@
+#include "registry.hpp"
+
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "basic_registry.hpp"
+#include "command_buffer.hpp"
+#include "common.hpp"
+#include "concurrent_registry.hpp"
+#include "delta.hpp"
+#include "entity.hpp"
+#include "memory_resource.hpp"
+#include "snapshot.hpp"
+
+static void populate(yacs::registry& registry, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    registry.create();
+  }
+}
+
+static void registry_create(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    yacs::registry registry;
+    populate(registry, n);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_create)->Apply(entity_counts);
+
+static void registry_create_bulk(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  std::vector<yacs::entity_id> ids(n);
+  for (auto _ : state) {
+    yacs::registry registry;
+    registry.create(n, ids.begin());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_create_bulk)->Apply(entity_counts);
+
+static void registry_destroy(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    yacs::registry registry;
+    populate(registry, n);
+    for (size_t i = 0; i < n; ++i) {
+      registry.add<position>(yacs::get_entity_id(i, 0));
+    }
+    state.ResumeTiming();
+    for (size_t i = 0; i < n; ++i) {
+      registry.destroy(yacs::get_entity_id(i, 0));
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_destroy)->Apply(entity_counts);
+
+static void registry_destroy_bulk(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  std::vector<yacs::entity_id> ids(n);
+  for (auto _ : state) {
+    state.PauseTiming();
+    yacs::registry registry;
+    registry.create(n, ids.begin());
+    registry.add<position>(ids.begin(), ids.end(), position());
+    state.ResumeTiming();
+    registry.destroy(ids.begin(), ids.end());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_destroy_bulk)->Apply(entity_counts);
+
+// Despawns and respawns a tenth of the world per iteration.
+static void registry_churn(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  std::vector<yacs::entity_id> ids(n);
+  yacs::registry registry;
+  registry.create(n, ids.begin());
+  auto order = shuffled_indices(n);
+  size_t cursor = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < n / 10; ++i, cursor = (cursor + 1) % n) {
+      auto& id = ids[order[cursor]];
+      registry.destroy(id);
+      registry.create(1, &id);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * (n / 10));
+}
+BENCHMARK(registry_churn)->Apply(entity_counts);
+
+// Workers creating entities with a component each: through one mutex around
+// the registry, through a command_queue and a flush(), or through a
+// concurrent_registry and a sync().
+enum class ingest { locked, queued, concurrent };
+
+template <ingest Path>
+static void registry_threaded_create(benchmark::State& state) {
+  constexpr size_t THREADS = 4;
+  auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    yacs::registry registry;
+    yacs::command_queue queue;
+    yacs::concurrent_registry concurrent(registry);
+    std::mutex mutex;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+      threads.emplace_back([&] {
+        for (size_t i = 0; i < n / THREADS; ++i) {
+          if constexpr (Path == ingest::queued) {
+            auto& buffer = queue.local();
+            buffer.add<position>(buffer.create());
+          } else if constexpr (Path == ingest::concurrent) {
+            concurrent.add<position>(concurrent.create());
+          } else {
+            std::lock_guard<std::mutex> lock(mutex);
+            registry.create().add<position>();
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    queue.flush(registry);
+    concurrent.sync();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(registry_threaded_create, ingest::locked)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(registry_threaded_create, ingest::queued)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(registry_threaded_create, ingest::concurrent)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Migrates a tenth of a shard's entities to another shard and back, either
+// with get, add and destroy per entity or through move_to().
+template <bool Bulk>
+static void registry_migrate(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  yacs::registry shards[2];
+  std::vector<yacs::entity_id> ids(n);
+  shards[0].create(n, ids.begin());
+  shards[0].add<position>(ids.begin(), ids.end(), position());
+  shards[0].add<velocity>(ids.begin(), ids.end(), velocity());
+  auto order = shuffled_indices(n);
+  std::vector<yacs::entity_id> moving(n / 10);
+  size_t from = 0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < moving.size(); ++i) {
+      moving[i] = ids[order[i]];
+    }
+    auto& source = shards[from];
+    auto& target = shards[1 - from];
+    if constexpr (Bulk) {
+      auto translation =
+          source.move_to(target, moving.begin(), moving.end());
+      for (size_t i = 0; i < moving.size(); ++i) {
+        ids[order[i]] = translation[i].second;
+      }
+    } else {
+      for (size_t i = 0; i < moving.size(); ++i) {
+        yacs::entity_id id;
+        target.create(1, &id);
+        target.add<position>(id, source.get<position>(moving[i]));
+        target.add<velocity>(id, source.get<velocity>(moving[i]));
+        source.destroy(moving[i]);
+        ids[order[i]] = id;
+      }
+    }
+    from = 1 - from;
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * moving.size());
+}
+BENCHMARK_TEMPLATE(registry_migrate, false)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(registry_migrate, true)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+// Folds a shard with shuffled pools into a world that has free slots.
+template <bool Bulk>
+static void registry_merge(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  std::vector<yacs::entity_id> ids(n);
+  std::vector<yacs::entity_id> world_ids(10 * n);
+  for (auto _ : state) {
+    state.PauseTiming();
+    yacs::registry world, shard;
+    world.create(world_ids.size(), world_ids.begin());
+    world.destroy(world_ids.begin(), world_ids.begin() + 2 * n);
+    shard.create(n, ids.begin());
+    std::shuffle(ids.begin(), ids.end(), std::mt19937(42));
+    shard.add<position>(ids.begin(), ids.end(), position());
+    shard.add<velocity>(ids.begin(), ids.end(), velocity());
+    state.ResumeTiming();
+    if constexpr (Bulk) {
+      world.merge(shard);
+    } else {
+      for (auto id : ids) {
+        yacs::entity_id created;
+        world.create(1, &created);
+        world.add<position>(created, shard.get<position>(id));
+        world.add<velocity>(created, shard.get<velocity>(id));
+        shard.destroy(id);
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(registry_merge, false)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(registry_merge, true)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+static void basic_registry_destroy(benchmark::State& state) {
+  using world = yacs::basic_registry<position, velocity, mass>;
+  auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    world registry;
+    for (size_t i = 0; i < n; ++i) {
+      registry.add<position>(registry.create());
+    }
+    state.ResumeTiming();
+    for (size_t i = 0; i < n; ++i) {
+      registry.destroy(yacs::get_entity_id(i, 0));
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(basic_registry_destroy)->Apply(entity_counts);
+
+static void registry_add(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    yacs::registry registry;
+    populate(registry, n);
+    state.ResumeTiming();
+    for (size_t i = 0; i < n; ++i) {
+      registry.add<position>(yacs::get_entity_id(i, 0), 1.f, 2.f, 3.f);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_add)->Apply(entity_counts);
+
+static void registry_add_bulk(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  std::vector<yacs::entity_id> ids(n);
+  for (auto _ : state) {
+    state.PauseTiming();
+    yacs::registry registry;
+    registry.create(n, ids.begin());
+    state.ResumeTiming();
+    registry.add<position>(ids.begin(), ids.end(), position(1.f, 2.f, 3.f));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_add_bulk)->Apply(entity_counts);
+
+// Builds, iterates and tears down a whole world, optionally in an arena
+// that is released afterwards.
+template <bool Arena>
+static void registry_world(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  std::vector<yacs::entity_id> ids(n);
+  yacs::arena arena;
+  for (auto _ : state) {
+    {
+      yacs::registry registry(Arena ? &arena
+                                    : std::pmr::get_default_resource());
+      registry.create(n, ids.begin());
+      registry.add<position>(ids.begin(), ids.end(), position(1.f, 2.f, 3.f));
+      registry.add<velocity>(ids.begin(), ids.end(), velocity(1.f, 1.f, 1.f));
+      registry.view<position, velocity>().each(
+          [](position& p, const velocity& v) { p.x += v.x; });
+      benchmark::ClobberMemory();
+    }
+    arena.release();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(registry_world, false)->Apply(entity_counts);
+BENCHMARK_TEMPLATE(registry_world, true)->Apply(entity_counts);
+
+static void registry_get(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  yacs::registry registry;
+  populate(registry, n);
+  for (size_t i = 0; i < n; ++i) {
+    registry.add<position>(yacs::get_entity_id(i, 0), 1.f, 2.f, 3.f);
+  }
+  auto order = shuffled_indices(n);
+  for (auto _ : state) {
+    float sum = 0.f;
+    for (auto index : order) {
+      sum += registry.get<position>(yacs::get_entity_id(index, 0)).x;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_get)->Apply(entity_counts);
+
+static void registry_query(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids(n);
+  registry.create(n, ids.begin());
+  for (size_t i = 0; i < n; ++i) {
+    registry.add<position>(ids[i]);
+    if (i % 2 == 0) {
+      registry.add<velocity>(ids[i]);
+    }
+    if (i % 4 == 0) {
+      registry.add<mass>(ids[i]);
+    }
+  }
+  auto include = yacs::registry::mask<position, velocity>();
+  auto exclude = yacs::registry::mask<mass>();
+  for (auto _ : state) {
+    auto found = registry.query(include, exclude);
+    benchmark::DoNotOptimize(found.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_query)->Apply(entity_counts);
+
+static void registry_snapshot(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids(n);
+  registry.create(n, ids.begin());
+  registry.add<position>(ids.begin(), ids.end(), position());
+  registry.add<velocity>(ids.begin(), ids.end(), velocity());
+  const char* path = "yacs_bench_snapshot.bin";
+  for (auto _ : state) {
+    yacs::snapshot::save<position, velocity>(registry, path);
+    yacs::registry loaded;
+    yacs::snapshot::load<position, velocity>(loaded, path);
+    benchmark::ClobberMemory();
+  }
+  std::remove(path);
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_snapshot)->Apply(entity_counts);
+
+// Each frame 2% of the entities change: 1% move and 1% are destroyed and
+// recreated in the freed slot.
+static void registry_delta(benchmark::State& state) {
+  auto n = static_cast<size_t>(state.range(0));
+  yacs::registry world, baseline, remote;
+  std::vector<yacs::entity_id> ids(n);
+  world.create(n, ids.begin());
+  world.add<position>(ids.begin(), ids.end(), position());
+  world.add<velocity>(ids.begin(), ids.end(), velocity(1.f, 0.f, 0.f));
+  std::vector<uint8_t> bytes;
+  yacs::delta::encode<position, velocity>(baseline, world, bytes);
+  yacs::delta::apply<position, velocity>(baseline, bytes.data(), bytes.size());
+  yacs::delta::apply<position, velocity>(remote, bytes.data(), bytes.size());
+
+  std::mt19937 random(42);
+  size_t churn = n / 100;
+  size_t encoded = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (size_t i = 0; i < churn; ++i) {
+      auto& id = ids[random() % n];
+      if (world.valid(id)) {
+        world.get<position>(id).x += 1.f;
+      }
+    }
+    for (size_t i = 0; i < churn; ++i) {
+      auto& id = ids[random() % n];
+      if (world.valid(id)) {
+        world.destroy(id);
+        world.create(1, &id);
+        world.add<position>(id);
+      }
+    }
+    state.ResumeTiming();
+
+    yacs::delta::encode<position, velocity>(baseline, world, bytes);
+    yacs::delta::apply<position, velocity>(baseline, bytes.data(),
+                                           bytes.size());
+    yacs::delta::apply<position, velocity>(remote, bytes.data(), bytes.size());
+    encoded += bytes.size();
+  }
+  state.counters["bytes"] = benchmark::Counter(
+      static_cast<double>(encoded), benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(registry_delta)->Arg(1000000)->Unit(benchmark::kMicrosecond);
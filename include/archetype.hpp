@@ -0,0 +1,105 @@
+#ifndef YACS_ARCHETYPE_H
+#define YACS_ARCHETYPE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "thread_pool.hpp"
+#include "types.hpp"
+
+using std::vector;
+
+namespace yacs {
+
+constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+// Type-erased operations an archetype needs to shuffle a component around
+// without knowing its type.
+typedef struct column_info {
+  size_t size;
+  size_t align;
+  void (*relocate)(void* dst, void* src);
+  void (*destroy)(void* value);
+
+  template <typename T>
+  static column_info of() {
+    return {sizeof(T), alignof(T),
+            [](void* dst, void* src) {
+              new (dst) T(std::move(*static_cast<T*>(src)));
+              static_cast<T*>(src)->~T();
+            },
+            [](void* value) { static_cast<T*>(value)->~T(); }};
+  }
+} column_info;
+
+// Every entity with exactly the component set `types` lives here. Rows are
+// packed into fixed-size chunks, each laid out as an entity id column
+// followed by one array per component, so iterating a chunk only touches
+// contiguous memory.
+class archetype {
+ public:
+  static constexpr size_t NO_COLUMN = static_cast<size_t>(-1);
+  static constexpr size_t NO_ARCHETYPE = static_cast<size_t>(-1);
+
+  archetype(vector<component_id> types, const vector<column_info>& infos);
+  ~archetype();
+
+  archetype(const archetype& other) = delete;
+  archetype& operator=(const archetype& other) = delete;
+
+  const vector<component_id>& types() const { return m_types; }
+  size_t size() const { return m_size; }
+  size_t capacity() const { return m_capacity; }
+
+  size_t column(component_id id) const {
+    return id < m_columns.size() ? m_columns[id] : NO_COLUMN;
+  }
+
+  size_t chunk_count() const { return m_chunks.size(); }
+  size_t chunk_size(size_t chunk) const {
+    return std::min(m_capacity, m_size - chunk * m_capacity);
+  }
+
+  entity_id* entities(size_t chunk) {
+    return reinterpret_cast<entity_id*>(m_chunks[chunk]);
+  }
+
+  void* column_data(size_t chunk, size_t column) {
+    return m_chunks[chunk] + m_offsets[column];
+  }
+
+  entity_id& entity(size_t row) {
+    return entities(row / m_capacity)[row % m_capacity];
+  }
+
+  void* at(size_t row, size_t column) {
+    return m_chunks[row / m_capacity] + m_offsets[column] +
+           (row % m_capacity) * m_infos[column].size;
+  }
+
+  size_t push(entity_id id);
+  bool remove(size_t row);
+  void destroy(size_t row);
+
+  size_t& edge(component_id id, bool add);
+
+ protected:
+  vector<component_id> m_types;
+  vector<column_info> m_infos;
+  vector<size_t> m_columns;
+  vector<size_t> m_offsets;
+  vector<std::byte*> m_chunks;
+  vector<size_t> m_add_edges;
+  vector<size_t> m_remove_edges;
+  size_t m_capacity;
+  size_t m_chunk_bytes;
+  size_t m_chunk_align;
+  size_t m_size;
+};
+
+}  // namespace yacs
+
+#endif
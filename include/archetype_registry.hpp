@@ -0,0 +1,196 @@
+#ifndef YACS_ARCHETYPE_REGISTRY_H
+#define YACS_ARCHETYPE_REGISTRY_H
+
+#include <array>
+#include <cassert>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "archetype.hpp"
+#include "thread_pool.hpp"
+#include "types.hpp"
+
+using std::forward;
+using std::unique_ptr;
+using std::vector;
+
+namespace yacs {
+
+// Registry backed by archetype chunks instead of one packed_pool per
+// component. Adding or removing a component moves the entity to another
+// archetype, which makes structural changes more expensive, but each() walks
+// plain arrays of the matching chunks without probing any sparse set.
+class archetype_registry {
+ public:
+  archetype_registry();
+
+  archetype_registry(archetype_registry&& other) = default;
+  archetype_registry& operator=(archetype_registry&& other) = default;
+
+  entity_id create();
+  bool valid(entity_id id) const;
+  void destroy(entity_id id);
+
+  template <typename T, typename... Args>
+  T& add(entity_id id, Args&&... args) {
+    auto component_index = assure<T>();
+    auto& record = m_entities[get_entity_index(id)];
+    assert(m_archetypes[record.archetype]->column(component_index) ==
+               archetype::NO_COLUMN &&
+           "component already present");
+    move(get_entity_index(id),
+         transition(record.archetype, component_index, true));
+    auto& storage = *m_archetypes[record.archetype];
+    void* data = storage.at(record.row, storage.column(component_index));
+    return *new (data) T(forward<Args>(args)...);
+  }
+
+  template <typename T>
+  void destroy(entity_id id) {
+    auto component_index = assure<T>();
+    auto& record = m_entities[get_entity_index(id)];
+    if (m_archetypes[record.archetype]->column(component_index) ==
+        archetype::NO_COLUMN) {
+      return;
+    }
+    move(get_entity_index(id),
+         transition(record.archetype, component_index, false));
+  }
+
+  template <typename T>
+  bool has(entity_id id) const {
+    auto& record = m_entities[get_entity_index(id)];
+    return m_archetypes[record.archetype]->column(component_traits<T>::id()) !=
+           archetype::NO_COLUMN;
+  }
+
+  template <typename T>
+  T& get(entity_id id) {
+    auto& record = m_entities[get_entity_index(id)];
+    auto& storage = *m_archetypes[record.archetype];
+    auto column = storage.column(component_traits<T>::id());
+    assert(column != archetype::NO_COLUMN);
+    return *static_cast<T*>(storage.at(record.row, column));
+  }
+
+  template <typename... Ts, typename Fn>
+  void each(Fn fn) {
+    auto ids = component_ids<Ts...>();
+    std::array<size_t, sizeof...(Ts)> columns;
+    for (auto& storage : m_archetypes) {
+      if (!match(*storage, ids, columns)) {
+        continue;
+      }
+      for (size_t chunk = 0; chunk < storage->chunk_count(); ++chunk) {
+        visit<Ts...>(fn, *storage, chunk, columns,
+                     std::index_sequence_for<Ts...>());
+      }
+    }
+  }
+
+  template <typename... Ts, typename Fn>
+  void parallel_each(Fn fn) {
+    parallel_each<Ts...>(fn, thread_pool::shared());
+  }
+
+  template <typename... Ts, typename Fn, typename Executor>
+  void parallel_each(Fn fn, Executor& executor) {
+    auto ids = component_ids<Ts...>();
+    vector<std::pair<archetype*, size_t>> chunks;
+    vector<std::array<size_t, sizeof...(Ts)>> columns;
+    std::array<size_t, sizeof...(Ts)> matched;
+    for (auto& storage : m_archetypes) {
+      if (!match(*storage, ids, matched)) {
+        continue;
+      }
+      for (size_t chunk = 0; chunk < storage->chunk_count(); ++chunk) {
+        chunks.emplace_back(storage.get(), chunk);
+        columns.push_back(matched);
+      }
+    }
+    executor.parallel_for(chunks.size(), 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        visit<Ts...>(fn, *chunks[i].first, chunks[i].second, columns[i],
+                     std::index_sequence_for<Ts...>());
+      }
+    });
+  }
+
+  size_t size() const { return m_entities.size() - m_free.size(); }
+  size_t archetype_count() const { return m_archetypes.size(); }
+
+ protected:
+  typedef struct entity_record {
+    size_t archetype;
+    size_t row;
+    entity_version version;
+  } entity_record;
+
+  template <typename T>
+  component_id assure() {
+    auto component_index = component_traits<T>::id();
+    if (component_index >= m_infos.size()) {
+      m_infos.resize(component_index + 1);
+    }
+    if (!m_infos[component_index].relocate) {
+      m_infos[component_index] = column_info::of<T>();
+    }
+    return component_index;
+  }
+
+  template <typename... Ts>
+  std::array<component_id, sizeof...(Ts)> component_ids() {
+    static_assert(sizeof...(Ts) > 0, "each needs at least one component");
+    return {assure<std::remove_const_t<Ts>>()...};
+  }
+
+  template <size_t N>
+  static bool match(const archetype& storage,
+                    const std::array<component_id, N>& ids,
+                    std::array<size_t, N>& columns) {
+    if (storage.size() == 0) {
+      return false;
+    }
+    for (size_t i = 0; i < N; ++i) {
+      columns[i] = storage.column(ids[i]);
+      if (columns[i] == archetype::NO_COLUMN) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <typename... Ts, typename Fn, size_t... Is>
+  static void visit(Fn& fn, archetype& storage, size_t chunk,
+                    const std::array<size_t, sizeof...(Ts)>& columns,
+                    std::index_sequence<Is...>) {
+    each(fn, storage.entities(chunk), storage.chunk_size(chunk),
+         static_cast<Ts*>(storage.column_data(chunk, columns[Is]))...);
+  }
+
+  template <typename Fn, typename... Ts>
+  static void each(Fn& fn, const entity_id* ids, size_t size, Ts*... values) {
+    for (size_t i = 0; i < size; ++i) {
+      if constexpr (std::is_invocable_v<Fn&, entity_id, Ts&...>) {
+        fn(ids[i], values[i]...);
+      } else {
+        fn(values[i]...);
+      }
+    }
+  }
+
+  size_t transition(size_t from, component_id id, bool add);
+  size_t find(vector<component_id> types);
+  void move(entity_index index, size_t target);
+
+  vector<unique_ptr<archetype>> m_archetypes;
+  vector<column_info> m_infos;
+  vector<entity_record> m_entities;
+  vector<entity_index> m_free;
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef YACS_BASIC_REGISTRY_H
+#define YACS_BASIC_REGISTRY_H
+
+#include <cassert>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "pool.hpp"
+#include "types.hpp"
+#include "view.hpp"
+
+using std::forward;
+using std::vector;
+
+namespace yacs {
+
+// Registry over a component list fixed at compile time. The pools live by
+// value in a tuple, so every lookup resolves to a member at compile time and
+// destroy() is an inlined fold over the pools instead of virtual calls
+// through pool pointers.
+template <typename... Cs>
+class basic_registry {
+ public:
+  template <typename T>
+  using storage_type = yacs::packed_pool<T>;
+
+  template <typename T>
+  static constexpr bool holds = (std::is_same_v<T, Cs> || ...);
+
+  basic_registry() = default;
+
+  basic_registry(basic_registry&& other) = default;
+  basic_registry& operator=(basic_registry&& other) = default;
+
+  entity_id create() {
+    if (!m_free.empty()) {
+      auto index = m_free.back();
+      m_free.pop_back();
+      return get_entity_id(index, m_versions[index]);
+    }
+    auto index = static_cast<entity_index>(m_versions.size());
+    m_versions.push_back(0);
+    return get_entity_id(index, 0);
+  }
+
+  template <typename OutputIt>
+  void create(size_t n, OutputIt out) {
+    for (; n > 0 && !m_free.empty(); --n) {
+      *out++ = get_entity_id(m_free.back(), m_versions[m_free.back()]);
+      m_free.pop_back();
+    }
+    auto index = static_cast<entity_index>(m_versions.size());
+    m_versions.resize(m_versions.size() + n, 0);
+    for (auto last = index + n; index < last; ++index) {
+      *out++ = get_entity_id(index, 0);
+    }
+  }
+
+  bool valid(entity_id id) const {
+    auto index = get_entity_index(id);
+    return index < m_versions.size() &&
+           m_versions[index] == get_entity_version(id);
+  }
+
+  void destroy(entity_id id) {
+    auto index = get_entity_index(id);
+    std::apply(
+        [index](auto&... pools) {
+          ((pools.contains(index) ? pools.destroy(index) : void()), ...);
+        },
+        m_pools);
+    ++m_versions[index];
+    m_free.push_back(index);
+  }
+
+  template <typename It>
+  void destroy(It first, It last) {
+    std::apply(
+        [first, last](auto&... pools) {
+          (destroy_range(pools, first, last), ...);
+        },
+        m_pools);
+    for (; first != last; ++first) {
+      auto index = get_entity_index(*first);
+      ++m_versions[index];
+      m_free.push_back(index);
+    }
+  }
+
+  template <typename T>
+  void destroy(entity_id id) {
+    storage<T>().destroy(get_entity_index(id));
+  }
+
+  template <typename T, typename... Args>
+  T& add(entity_id id, Args&&... args) {
+    return storage<T>().construct(get_entity_index(id),
+                                  forward<Args>(args)...);
+  }
+
+  template <typename T>
+  bool has(entity_id id) const {
+    return storage<T>().contains(get_entity_index(id));
+  }
+
+  template <typename T>
+  T& get(entity_id id) {
+    return storage<T>().access(get_entity_index(id));
+  }
+
+  template <typename T>
+  storage_type<T>& storage() {
+    static_assert(holds<T>, "component is not part of this registry");
+    return std::get<storage_type<T>>(m_pools);
+  }
+
+  template <typename T>
+  const storage_type<T>& storage() const {
+    static_assert(holds<T>, "component is not part of this registry");
+    return std::get<storage_type<T>>(m_pools);
+  }
+
+  template <typename... Ts>
+  yacs::view<Ts...> view() {
+    return yacs::view<Ts...>(storage<std::remove_const_t<Ts>>()...);
+  }
+
+  size_t size() const { return m_versions.size() - m_free.size(); }
+
+ protected:
+  template <typename T, typename It>
+  static void destroy_range(storage_type<T>& pool, It first, It last) {
+    for (; first != last; ++first) {
+      auto index = get_entity_index(*first);
+      if (pool.contains(index)) {
+        pool.destroy(index);
+      }
+    }
+  }
+
+  basic_registry(const basic_registry& other) = delete;
+  basic_registry& operator=(const basic_registry& other) = delete;
+
+  std::tuple<storage_type<Cs>...> m_pools;
+  vector<entity_version> m_versions;
+  vector<entity_index> m_free;
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef YACS_COMMAND_BUFFER_H
+#define YACS_COMMAND_BUFFER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "registry.hpp"
+#include "types.hpp"
+
+using std::pair;
+using std::unique_ptr;
+using std::vector;
+
+namespace yacs {
+
+// Records structural changes and applies them later in one pass. Entities
+// returned by create() are placeholders that resolve on flush. Playback runs
+// creates first, then each pool's adds and removes ordered by entity index,
+// keeping the recorded order per entity, and destroys last.
+//
+// A placeholder's version is PLACEHOLDER_BIT plus the serial of the buffer
+// that made it. Commands naming a placeholder of another buffer are dropped
+// on playback instead of landing on whatever this buffer created at that
+// index.
+class command_buffer {
+ public:
+  static constexpr entity_version PLACEHOLDER_BIT = entity_version(1) << 31;
+
+  command_buffer();
+
+  command_buffer(command_buffer&& other) = default;
+  command_buffer& operator=(command_buffer&& other) = default;
+
+  entity_id create();
+  void destroy(entity_id id);
+
+  template <typename T, typename... Args>
+  void add(entity_id id, Args&&... args) {
+    auto& commands = this->commands<T>();
+    commands.ops.emplace_back();
+    commands.ops.back().id = id;
+    commands.ops.back().value.emplace(forward<Args>(args)...);
+    ++commands.adds;
+  }
+
+  template <typename T>
+  void remove(entity_id id) {
+    commands<T>().ops.emplace_back().id = id;
+  }
+
+  bool empty() const;
+  void clear();
+  void flush(registry& registry);
+
+  static bool placeholder(entity_id id) {
+    return (get_entity_version(id) & PLACEHOLDER_BIT) != 0;
+  }
+
+ protected:
+  friend class command_queue;
+  friend class concurrent_registry;
+
+  struct pool_commands {
+    virtual ~pool_commands() = default;
+    virtual void apply(registry& registry, entity_version owner,
+                       const vector<entity_id>& created) = 0;
+    virtual bool empty() const = 0;
+    virtual void clear() = 0;
+  };
+
+  // One list per pool so an add and a remove of the same entity apply in
+  // the order they were recorded; an op without a value is a remove.
+  template <typename T>
+  struct typed_commands : pool_commands {
+    struct op {
+      entity_id id;
+      std::optional<T> value;
+    };
+
+    void apply(registry& registry, entity_version owner,
+               const vector<entity_id>& created) override {
+      for (auto& op : ops) {
+        op.id = resolve(op.id, owner, created);
+      }
+      // Ids from one producer, placeholders included, usually arrive in
+      // index order already.
+      auto by_entity = [](const op& lhs, const op& rhs) {
+        return by_index(lhs.id, rhs.id);
+      };
+      if (!std::is_sorted(ops.begin(), ops.end(), by_entity)) {
+        std::stable_sort(ops.begin(), ops.end(), by_entity);
+      }
+      registry.storage<T>().grow(adds);
+      for (auto& op : ops) {
+        if (!registry.valid(op.id)) {
+          continue;
+        }
+        if (!op.value) {
+          if (registry.has<T>(op.id)) {
+            registry.destroy<T>(op.id);
+          }
+        } else if (registry.has<T>(op.id)) {
+          registry.replace<T>(op.id, std::move(*op.value));
+        } else {
+          registry.add<T>(op.id, std::move(*op.value));
+        }
+      }
+    }
+
+    bool empty() const override { return ops.empty(); }
+
+    void clear() override {
+      ops.clear();
+      adds = 0;
+    }
+
+    vector<op> ops;
+    size_t adds = 0;
+  };
+
+  template <typename T>
+  typed_commands<T>& commands() {
+    auto component_index = component_traits<T>::id();
+    if (component_index >= m_commands.size()) {
+      m_commands.resize(component_index + 1);
+    }
+    if (!m_commands[component_index]) {
+      m_commands[component_index].reset(new typed_commands<T>());
+    }
+    return static_cast<typed_commands<T>&>(*m_commands[component_index]);
+  }
+
+  entity_version placeholder_version() const {
+    return PLACEHOLDER_BIT | m_serial;
+  }
+
+  // Placeholders of the owner buffer map to the entities it created. Any
+  // other placeholder is left as is; its version has PLACEHOLDER_BIT set,
+  // which no live entity reaches, so valid() rejects it and it is skipped.
+  static entity_id resolve(entity_id id, entity_version owner,
+                           const vector<entity_id>& created) {
+    if (!placeholder(id) || get_entity_version(id) != owner ||
+        get_entity_index(id) >= created.size()) {
+      return id;
+    }
+    return created[get_entity_index(id)];
+  }
+
+  static bool by_index(entity_id lhs, entity_id rhs) {
+    return get_entity_index(lhs) < get_entity_index(rhs);
+  }
+
+  static void playback(registry& registry,
+                       const vector<command_buffer*>& buffers);
+
+  entity_version m_serial;
+  size_t m_created;
+  vector<entity_id> m_destroyed;
+  vector<unique_ptr<pool_commands>> m_commands;
+};
+
+// Hands every thread its own command_buffer and plays them all back together
+// so commands for the same pool from different threads are applied in one
+// batch. local() only locks the first time a thread asks a queue for its
+// buffer; flush() must not run while other threads still record.
+class command_queue {
+ public:
+  command_queue();
+
+  command_buffer& local();
+  void flush(registry& registry);
+
+ protected:
+  uint64_t m_serial;
+  std::mutex m_mutex;
+  vector<pair<std::thread::id, unique_ptr<command_buffer>>> m_buffers;
+};
+
+}  // namespace yacs
+
+#endif
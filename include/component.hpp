@@ -9,7 +9,7 @@ template <typename T, typename storage_type = packed_pool<T>>
 class component {
  public:
   component()
-      : index(static_cast<storage_type::size_type>(-1)), storage(nullptr) {}
+      : index(static_cast<typename storage_type::size_type>(-1)), storage(nullptr) {}
   component(storage_type* storage, typename storage_type::index_type index)
       : index(index), storage(storage) {}
 
@@ -0,0 +1,150 @@
+#ifndef YACS_COMPONENT_MASK_H
+#define YACS_COMPONENT_MASK_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifndef YACS_MAX_COMPONENTS
+#define YACS_MAX_COMPONENTS 128
+#endif
+
+using std::uint32_t;
+using std::uint64_t;
+
+namespace yacs {
+
+constexpr uint32_t MAX_COMPONENTS = YACS_MAX_COMPONENTS;
+
+static_assert(MAX_COMPONENTS == 128 || MAX_COMPONENTS == 256 ||
+                  MAX_COMPONENTS == 512,
+              "YACS_MAX_COMPONENTS must be 128, 256 or 512");
+
+inline size_t lowest_bit(uint64_t word) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, word);
+  return index;
+#else
+  return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+}
+
+// Fixed-width bit set with one bit per component id. It is aligned to its
+// own size (up to a cache line) so a mask can be loaded with aligned vector
+// loads when scanning entity slots.
+class alignas(MAX_COMPONENTS / 8 < 64 ? MAX_COMPONENTS / 8 : 64)
+    component_mask {
+ public:
+  static constexpr size_t WORD_BITS = 64;
+  static constexpr size_t WORDS = MAX_COMPONENTS / WORD_BITS;
+
+  component_mask() : m_words{} {}
+
+  component_mask& set(size_t bit) {
+    assert(bit < MAX_COMPONENTS && "raise YACS_MAX_COMPONENTS");
+    m_words[bit / WORD_BITS] |= uint64_t(1) << (bit % WORD_BITS);
+    return *this;
+  }
+
+  component_mask& reset(size_t bit) {
+    assert(bit < MAX_COMPONENTS && "raise YACS_MAX_COMPONENTS");
+    m_words[bit / WORD_BITS] &= ~(uint64_t(1) << (bit % WORD_BITS));
+    return *this;
+  }
+
+  component_mask& reset() {
+    for (auto& word : m_words) {
+      word = 0;
+    }
+    return *this;
+  }
+
+  bool test(size_t bit) const {
+    return bit < MAX_COMPONENTS &&
+           (m_words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+  }
+
+  bool any() const {
+    for (auto word : m_words) {
+      if (word) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool none() const { return !any(); }
+
+  size_t count() const {
+    size_t bits = 0;
+    for (auto word : m_words) {
+      for (; word; word &= word - 1) {
+        ++bits;
+      }
+    }
+    return bits;
+  }
+
+  bool includes(const component_mask& other) const {
+    for (size_t i = 0; i < WORDS; ++i) {
+      if ((m_words[i] & other.m_words[i]) != other.m_words[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool intersects(const component_mask& other) const {
+    for (size_t i = 0; i < WORDS; ++i) {
+      if (m_words[i] & other.m_words[i]) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  template <typename Fn>
+  void each(Fn fn) const {
+    for (size_t i = 0; i < WORDS; ++i) {
+      for (auto word = m_words[i]; word; word &= word - 1) {
+        fn(i * WORD_BITS + lowest_bit(word));
+      }
+    }
+  }
+
+  const uint64_t* words() const { return m_words; }
+
+  bool operator==(const component_mask& other) const {
+    for (size_t i = 0; i < WORDS; ++i) {
+      if (m_words[i] != other.m_words[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool operator!=(const component_mask& other) const {
+    return !(*this == other);
+  }
+
+  bool operator<(const component_mask& other) const {
+    for (size_t i = WORDS; i-- > 0;) {
+      if (m_words[i] != other.m_words[i]) {
+        return m_words[i] < other.m_words[i];
+      }
+    }
+    return false;
+  }
+
+ protected:
+  uint64_t m_words[WORDS];
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef YACS_CONCURRENT_REGISTRY_H
+#define YACS_CONCURRENT_REGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "command_buffer.hpp"
+#include "registry.hpp"
+#include "types.hpp"
+
+using std::pair;
+using std::unique_ptr;
+using std::vector;
+
+namespace yacs {
+
+// Lets many threads create entities and add components to one registry
+// without a lock around it. create() hands out real ids straight away:
+// recycled slots are popped off the registry's free list with a CAS and
+// fresh indices are reserved with a fetch_add past the end of the entity
+// table. add() is staged in a per-thread command_buffer. sync() then runs on
+// one thread, builds the reserved slots and plays every stage back in one
+// batch per pool.
+//
+// While workers use it the registry may be read but not changed directly,
+// and sync() has to run before it is; ids created here are not valid() on
+// the registry until then. Nothing is pushed onto the free list between
+// syncs, so the pop cannot meet a recycled head (ABA) and needs no tag.
+class concurrent_registry {
+ public:
+  explicit concurrent_registry(registry& registry);
+
+  concurrent_registry(const concurrent_registry& other) = delete;
+  concurrent_registry& operator=(const concurrent_registry& other) = delete;
+
+  entity_id create();
+
+  template <typename OutputIt>
+  void create(size_t n, OutputIt out) {
+    auto& recycled = local().recycled;
+    for (; n > 0; --n) {
+      auto index = pop_free();
+      if (index == registry::NO_FREE_SLOT) {
+        break;
+      }
+      recycled.push_back(index);
+      *out++ = get_entity_id(index, version(index));
+    }
+    if (n == 0) {
+      return;
+    }
+    auto index = reserve(n);
+    for (auto last = index + n; index < last; ++index) {
+      *out++ = get_entity_id(index, 0);
+    }
+  }
+
+  template <typename T, typename... Args>
+  void add(entity_id id, Args&&... args) {
+    local().commands.add<T>(id, forward<Args>(args)...);
+  }
+
+  // Not thread safe; no worker may use this object while it runs.
+  void sync();
+
+ protected:
+  struct stage {
+    command_buffer commands;
+    vector<entity_index> recycled;
+  };
+
+  stage& local();
+  entity_index pop_free();
+
+  entity_version version(entity_index index) const {
+    return std::as_const(m_registry.m_entities)[index].version;
+  }
+
+  entity_index reserve(size_t n) {
+    auto offset = m_reserved.fetch_add(n, std::memory_order_relaxed);
+    return static_cast<entity_index>(m_registry.m_entities.size() + offset);
+  }
+
+  registry& m_registry;
+  std::atomic<size_t> m_reserved;
+  uint64_t m_serial;
+  std::mutex m_mutex;
+  vector<pair<std::thread::id, unique_ptr<stage>>> m_stages;
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef YACS_DELTA_H
+#define YACS_DELTA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "pool.hpp"
+#include "registry.hpp"
+#include "types.hpp"
+
+using std::pair;
+using std::uint8_t;
+using std::uint64_t;
+using std::vector;
+
+namespace yacs {
+
+void write_varint(vector<uint8_t>& out, uint64_t value);
+
+// Bounds-checked cursor over an encoded delta.
+class delta_reader {
+ public:
+  delta_reader(const uint8_t* data, size_t size)
+      : m_data(data), m_size(size), m_position(0) {}
+
+  bool varint(uint64_t& value);
+  bool bytes(size_t count, const uint8_t*& data);
+
+  template <typename U>
+  bool value(U& out) {
+    const uint8_t* data;
+    if (!bytes(sizeof(U), data)) {
+      return false;
+    }
+    std::memcpy(&out, data, sizeof(U));
+    return true;
+  }
+
+  size_t remaining() const { return m_size - m_position; }
+  bool done() const { return m_position == m_size; }
+
+ protected:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_position;
+};
+
+// Byte-wise XOR of a value against its baseline, run-length encoded. A
+// control byte below 0x80 stands for (byte + 1) zero bytes, i.e. unchanged
+// bytes; otherwise (byte & 0x7f) + 1 literal XOR bytes follow it.
+class xor_rle_encoder {
+ public:
+  explicit xor_rle_encoder(vector<uint8_t>& out)
+      : m_out(out), m_zeros(0), m_literals(0), m_control(0) {}
+
+  // A null baseline encodes the value against zeros.
+  void push(const uint8_t* value, const uint8_t* baseline, size_t size);
+  void finish();
+
+ protected:
+  void flush_zeros();
+  void end_literals();
+
+  vector<uint8_t>& m_out;
+  size_t m_zeros;
+  size_t m_literals;
+  size_t m_control;
+};
+
+class xor_rle_decoder {
+ public:
+  xor_rle_decoder(const uint8_t* data, size_t size)
+      : m_data(data), m_size(size), m_position(0), m_zeros(0), m_literals(0) {}
+
+  // XORs the next size bytes of the stream into target.
+  bool apply(uint8_t* target, size_t size);
+
+  // Whether every run in the stream was consumed exactly.
+  bool done() const {
+    return m_position == m_size && m_zeros == 0 && m_literals == 0;
+  }
+
+ protected:
+  const uint8_t* m_data;
+  size_t m_size;
+  size_t m_position;
+  size_t m_zeros;
+  size_t m_literals;
+};
+
+// Encodes the difference between two registries over the listed component
+// types: destroyed and created entities, then per component the removed,
+// added and changed elements. A slot whose version moved on is a recycled
+// entity and is sent as a destroy plus a create. A sender keeps its own
+// baseline current by applying each delta it sends to it.
+class delta {
+ public:
+  template <typename... Ts>
+  static void encode(const registry& baseline, const registry& current,
+                     vector<uint8_t>& out) {
+    static_assert((std::is_trivially_copyable_v<Ts> && ...),
+                  "deltas are encoded bytewise");
+    out.clear();
+    vector<uint8_t> states;
+    vector<entity_index> destroyed;
+    encode_entities(baseline, current, states, destroyed, out);
+    write_varint(out, sizeof...(Ts));
+    (encode_pool<Ts>(baseline, current, states, destroyed, out), ...);
+  }
+
+  template <typename... Ts>
+  static bool apply(registry& target, const uint8_t* data, size_t size) {
+    static_assert((std::is_trivially_copyable_v<Ts> && ...),
+                  "deltas are encoded bytewise");
+    delta_reader in(data, size);
+    uint64_t sections;
+    if (!apply_entities(target, in) || !in.varint(sections)) {
+      return false;
+    }
+    for (; sections > 0; --sections) {
+      uint64_t hash;
+      if (!in.value(hash) ||
+          !((hash == component_traits<Ts>::hash &&
+             apply_pool<Ts>(target, in)) ||
+            ...)) {
+        return false;
+      }
+    }
+    return in.done();
+  }
+
+ protected:
+  // Per-index entity changes recorded by encode_entities.
+  static constexpr uint8_t DESTROYED = 1;
+  static constexpr uint8_t CREATED = 2;
+
+  template <typename T>
+  static const packed_pool<T>* find_pool(const registry& registry) {
+    auto component_index = component_traits<T>::id();
+    return component_index < registry.m_pools.size()
+               ? static_cast<const packed_pool<T>*>(
+                     registry.m_pools[component_index])
+               : nullptr;
+  }
+
+  template <typename T>
+  static void encode_pool(const registry& baseline, const registry& current,
+                          const vector<uint8_t>& states,
+                          const vector<entity_index>& destroyed,
+                          vector<uint8_t>& out) {
+    auto* before = find_pool<T>(baseline);
+    auto* after = find_pool<T>(current);
+    auto state = [&states](pool::index_type index) {
+      return index < states.size() ? states[index] : uint8_t(0);
+    };
+
+    vector<pool::index_type> removed;
+    vector<pair<pool::index_type, size_t>> added;
+    vector<pair<pool::index_type, size_t>> changed;
+    size_t matched = 0;
+    if (after) {
+      // A baseline kept in sync by apply() mostly shares the packed order,
+      // so try the same position before a sparse lookup.
+      auto* same_order = before ? before->data() : nullptr;
+      auto shared = before ? std::min(before->size(), after->size()) : 0;
+      for (size_t i = 0; i < after->size(); ++i) {
+        auto index = after->data()[i];
+        const T* old_value = nullptr;
+        if (before && !(state(index) & CREATED)) {
+          if (i < shared && same_order[i] == index) {
+            old_value = &column_at(before->raw(), i);
+          } else if (before->contains(index)) {
+            old_value = &(*before)[index];
+          }
+        }
+        if (!old_value) {
+          added.emplace_back(index, i);
+          continue;
+        }
+        ++matched;
+        if (!is_tag_v<T> &&
+            std::memcmp(&after->raw()[i], old_value, sizeof(T)) != 0) {
+          changed.emplace_back(index, i);
+        }
+      }
+    }
+    // Every surviving baseline element was matched above, so the full scan
+    // for removals only runs when the counts leave some unaccounted for.
+    for (auto index : destroyed) {
+      matched += before && before->contains(index);
+    }
+    if (before && matched < before->size()) {
+      for (size_t i = 0; i < before->size(); ++i) {
+        auto index = before->data()[i];
+        if (!(state(index) & DESTROYED) && !(after && after->contains(index))) {
+          removed.push_back(index);
+        }
+      }
+    }
+    std::sort(removed.begin(), removed.end());
+    std::sort(added.begin(), added.end());
+    std::sort(changed.begin(), changed.end());
+
+    auto first = [](auto& entry) { return entry.first; };
+    write_value(out, component_traits<T>::hash);
+    write_indices(out, removed.begin(), removed.end(),
+                  [](pool::index_type index) { return index; });
+    write_indices(out, added.begin(), added.end(), first);
+    write_indices(out, changed.begin(), changed.end(), first);
+
+    // Tags are membership only and carry no value bytes.
+    vector<uint8_t> stream;
+    xor_rle_encoder encoder(stream);
+    if constexpr (!is_tag_v<T>) {
+      for (auto& entry : added) {
+        encoder.push(
+            reinterpret_cast<const uint8_t*>(&after->raw()[entry.second]),
+            nullptr, sizeof(T));
+      }
+      for (auto& entry : changed) {
+        encoder.push(
+            reinterpret_cast<const uint8_t*>(&after->raw()[entry.second]),
+            reinterpret_cast<const uint8_t*>(&(*before)[entry.first]),
+            sizeof(T));
+      }
+    }
+    encoder.finish();
+    write_varint(out, stream.size());
+    out.insert(out.end(), stream.begin(), stream.end());
+  }
+
+  template <typename T>
+  static bool apply_pool(registry& target, delta_reader& in) {
+    vector<pool::index_type> removed, added, changed;
+    uint64_t stream_size;
+    const uint8_t* stream;
+    if (!read_indices(in, removed) || !read_indices(in, added) ||
+        !read_indices(in, changed) || !in.varint(stream_size) ||
+        !in.bytes(stream_size, stream)) {
+      return false;
+    }
+
+    auto* storage = target.assure<T>();
+    for (auto index : removed) {
+      if (!storage->contains(index)) {
+        return false;
+      }
+      target.destroy<T>(target.id(static_cast<entity_index>(index)));
+    }
+
+    xor_rle_decoder decoder(stream, stream_size);
+    storage->grow(added.size());
+    for (auto index : added) {
+      // Destroyed slots stay in m_entities as free list links, so only a
+      // slot pointing at itself is live.
+      if (!target.m_entities.contains(index) ||
+          target.m_entities[index].index != index ||
+          storage->contains(index)) {
+        return false;
+      }
+      if constexpr (is_tag_v<T>) {
+        target.add<T>(target.id(static_cast<entity_index>(index)));
+      } else {
+        alignas(T) uint8_t bytes[sizeof(T)] = {};
+        if (!decoder.apply(bytes, sizeof(T))) {
+          return false;
+        }
+        target.add<T>(target.id(static_cast<entity_index>(index)),
+                      *reinterpret_cast<const T*>(bytes));
+      }
+    }
+    for (auto index : changed) {
+      if (!storage->contains(index)) {
+        return false;
+      }
+      bool decoded = true;
+      storage->patch(index, [&](T& value) {
+        decoded = decoder.apply(reinterpret_cast<uint8_t*>(&value), sizeof(T));
+      });
+      if (!decoded) {
+        return false;
+      }
+    }
+    return decoder.done();
+  }
+
+  static void encode_entities(const registry& baseline,
+                              const registry& current, vector<uint8_t>& states,
+                              vector<entity_index>& destroyed,
+                              vector<uint8_t>& out);
+  static bool apply_entities(registry& target, delta_reader& in);
+
+  template <typename U>
+  static void write_value(vector<uint8_t>& out, const U& value) {
+    auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(U));
+  }
+
+  // Ascending indices as a count followed by varint gaps.
+  template <typename It, typename Fn>
+  static void write_indices(vector<uint8_t>& out, It first, It last,
+                            Fn index_of) {
+    write_varint(out, static_cast<uint64_t>(std::distance(first, last)));
+    pool::index_type previous = 0;
+    for (; first != last; ++first) {
+      auto index = index_of(*first);
+      write_varint(out, index - previous);
+      previous = index;
+    }
+  }
+
+  static bool read_indices(delta_reader& in, vector<pool::index_type>& indices);
+};
+
+}  // namespace yacs
+
+#endif
@@ -29,11 +29,12 @@ class entity {
 
  protected:
   friend class registry;
+  friend class command_buffer;
 
-  entity(entity_id id, registry* registry) : id(id), registry(registry) {}
+  entity(entity_id id, yacs::registry* registry) : id(id), registry(registry) {}
 
   entity_id id;
-  registry* registry;
+  yacs::registry* registry;
 };
 
 }  // namespace yacs
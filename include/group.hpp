@@ -0,0 +1,217 @@
+#ifndef YACS_GROUP_H
+#define YACS_GROUP_H
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pool.hpp"
+
+namespace yacs {
+
+class group_handler {
+ public:
+  using index_type = pool::index_type;
+  using size_type = size_t;
+
+  group_handler() : m_size(0) {}
+  virtual ~group_handler() = default;
+
+  virtual void on_construct(index_type index) = 0;
+  virtual void on_destroy(index_type index) = 0;
+  virtual void on_destroy(const index_type* indices, size_type n) = 0;
+  virtual size_type owned() const = 0;
+  // Destroys a handler allocated from resource and frees its memory there.
+  virtual void dispose(std::pmr::memory_resource* resource) = 0;
+
+  const size_type* size() const { return &m_size; }
+
+ protected:
+  size_type m_size;
+};
+
+template <typename... Ts>
+class owning_group_handler : public group_handler {
+ public:
+  explicit owning_group_handler(packed_pool<Ts>&... pools)
+      : m_pools(&pools...) {
+    auto* lead = std::get<0>(m_pools);
+    for (size_type i = 0; i < lead->size(); ++i) {
+      on_construct(lead->sparse_index(i));
+    }
+  }
+
+  void on_construct(index_type index) override {
+    if (!contains_all(index) || member(index)) {
+      return;
+    }
+    std::apply(
+        [this, index](auto*... pools) {
+          (pools->swap_elements(pools->sparse_index(m_size), index), ...);
+        },
+        m_pools);
+    ++m_size;
+  }
+
+  void on_destroy(index_type index) override {
+    if (!member(index)) {
+      return;
+    }
+    --m_size;
+    std::apply(
+        [this, index](auto*... pools) {
+          (pools->swap_elements(pools->sparse_index(m_size), index), ...);
+        },
+        m_pools);
+  }
+
+  void on_destroy(const index_type* indices, size_type n) override {
+    for (size_type i = 0; i < n; ++i) {
+      on_destroy(indices[i]);
+    }
+  }
+
+  size_type owned() const override { return sizeof...(Ts); }
+
+  void dispose(std::pmr::memory_resource* resource) override {
+    delete_object(resource, this);
+  }
+
+ protected:
+  bool contains_all(index_type index) const {
+    return std::apply(
+        [index](auto*... pools) { return (pools->contains(index) && ...); },
+        m_pools);
+  }
+
+  bool member(index_type index) const {
+    auto* lead = std::get<0>(m_pools);
+    return lead->contains(index) && lead->packed_index(index) < m_size;
+  }
+
+  std::tuple<packed_pool<Ts>*...> m_pools;
+};
+
+template <typename... Ts>
+class group {
+  static_assert(sizeof...(Ts) > 0, "a group needs at least one component");
+
+ public:
+  using index_type = pool::index_type;
+  using size_type = size_t;
+  using values_type = std::tuple<typename packed_pool<Ts>::value_iterator...>;
+
+  class iterator {
+   public:
+    using value_type = std::tuple<Ts&...>;
+    using reference = value_type;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    iterator() : m_position(0) {}
+    iterator(values_type values, size_type start)
+        : m_values(values), m_position(start) {}
+
+    iterator& operator++() {
+      std::apply([](auto&... values) { (++values, ...); }, m_values);
+      ++m_position;
+      return *this;
+    }
+
+    iterator operator++(int) {
+      auto copy = *this;
+      ++(*this);
+      return copy;
+    }
+
+    bool operator==(const iterator& other) const {
+      return m_position == other.m_position;
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    value_type operator*() const {
+      return std::apply(
+          [](auto&... values) { return value_type(*values...); }, m_values);
+    }
+
+   protected:
+    values_type m_values;
+    size_type m_position;
+  };
+
+  group(const size_type* size, packed_pool<Ts>&... pools)
+      : m_size(size), m_pools(&pools...) {}
+
+  template <typename Fn>
+  void each(Fn fn) {
+    auto* indices = std::get<0>(m_pools)->data();
+    std::apply(
+        [&](auto*... pools) {
+          each(fn, indices, 0, *m_size, pools->raw()...);
+          (pools->touch_packed(0, *m_size), ...);
+        },
+        m_pools);
+  }
+
+  template <typename Fn>
+  void parallel_each(Fn fn) {
+    parallel_each(fn, thread_pool::shared());
+  }
+
+  template <typename Fn, typename Executor>
+  void parallel_each(Fn fn, Executor& executor) {
+    using lead_type = std::tuple_element_t<0, std::tuple<Ts...>>;
+    auto* indices = std::get<0>(m_pools)->data();
+    auto size = *m_size;
+    auto grain = chunk_size<lead_type>(size, executor.concurrency());
+    std::apply(
+        [&](auto*... pools) {
+          executor.parallel_for(size, grain, [&](size_t begin, size_t end) {
+            each(fn, indices, begin, end, pools->raw()...);
+            (pools->touch_packed(begin, end), ...);
+          });
+        },
+        m_pools);
+  }
+
+  iterator begin() const {
+    return iterator(std::apply(
+                        [](auto*... pools) {
+                          return values_type(pools->begin()...);
+                        },
+                        m_pools),
+                    0);
+  }
+
+  iterator end() const { return iterator(values_type(), *m_size); }
+
+  size_type size() const { return *m_size; }
+  bool empty() const { return *m_size == 0; }
+
+  bool contains(index_type index) const {
+    auto* lead = std::get<0>(m_pools);
+    return lead->contains(index) && lead->packed_index(index) < *m_size;
+  }
+
+ protected:
+  template <typename Fn>
+  static void each(Fn& fn, const index_type* indices, size_type begin,
+                   size_type end, Ts*... values) {
+    for (size_type i = begin; i < end; ++i) {
+      if constexpr (std::is_invocable_v<Fn&, index_type, Ts&...>) {
+        fn(indices[i], column_at(values, i)...);
+      } else {
+        fn(column_at(values, i)...);
+      }
+    }
+  }
+
+  const size_type* m_size;
+  std::tuple<packed_pool<Ts>*...> m_pools;
+};
+
+}  // namespace yacs
+
+#endif
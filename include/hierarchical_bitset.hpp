@@ -0,0 +1,120 @@
+#ifndef YACS_HIERARCHICAL_BITSET_H
+#define YACS_HIERARCHICAL_BITSET_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "component_mask.hpp"
+
+using std::uint64_t;
+using std::vector;
+
+namespace yacs {
+
+// Presence bits for a set of indices. Layer 0 holds one bit per index and
+// every layer above holds one bit per non-empty word of the layer below, up
+// to a single top word. Intersections walk the layers top down and skip any
+// 64-word region that is empty in one of the sets.
+class hierarchical_bitset {
+ public:
+  using index_type = size_t;
+  static constexpr size_t WORD_BITS = 64;
+
+  explicit hierarchical_bitset(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : m_layers(resource) {
+    m_layers.emplace_back(1, 0);
+  }
+  hierarchical_bitset(const hierarchical_bitset& other) = default;
+  hierarchical_bitset(const hierarchical_bitset& other,
+                      std::pmr::memory_resource* resource)
+      : m_layers(other.m_layers, resource) {}
+
+  inline void set(index_type index) {
+    if (index >= capacity()) {
+      grow(index);
+    }
+    for (auto& layer : m_layers) {
+      auto& word = layer[index / WORD_BITS];
+      bool was_empty = word == 0;
+      word |= uint64_t(1) << (index % WORD_BITS);
+      if (!was_empty) {
+        return;
+      }
+      index /= WORD_BITS;
+    }
+  }
+
+  inline void reset(index_type index) {
+    if (index >= capacity()) {
+      return;
+    }
+    for (auto& layer : m_layers) {
+      auto& word = layer[index / WORD_BITS];
+      word &= ~(uint64_t(1) << (index % WORD_BITS));
+      if (word != 0) {
+        return;
+      }
+      index /= WORD_BITS;
+    }
+  }
+
+  inline bool test(index_type index) const {
+    return (word(0, index / WORD_BITS) >> (index % WORD_BITS)) & 1;
+  }
+
+  void clear();
+
+  size_t capacity() const { return m_layers[0].size() * WORD_BITS; }
+  size_t layers() const { return m_layers.size(); }
+
+  // Layers above the top behave as a single full word so sets of different
+  // heights can be intersected together.
+  inline uint64_t word(size_t layer, size_t position) const {
+    if (layer >= m_layers.size()) {
+      return position == 0 ? ~uint64_t(0) : 0;
+    }
+    auto& words = m_layers[layer];
+    return position < words.size() ? words[position] : 0;
+  }
+
+  template <size_t N, typename Fn>
+  static void intersect(const std::array<const hierarchical_bitset*, N>& sets,
+                        Fn fn) {
+    size_t top = 0;
+    for (auto* set : sets) {
+      top = std::max(top, set->layers() - 1);
+    }
+    visit(sets, top, 0, fn);
+  }
+
+ protected:
+  template <size_t N, typename Fn>
+  static void visit(const std::array<const hierarchical_bitset*, N>& sets,
+                    size_t layer, size_t position, Fn& fn) {
+    auto word = ~uint64_t(0);
+    for (auto* set : sets) {
+      word &= set->word(layer, position);
+    }
+    for (; word; word &= word - 1) {
+      auto child = position * WORD_BITS + lowest_bit(word);
+      if (layer == 0) {
+        fn(child);
+      } else {
+        visit(sets, layer - 1, child, fn);
+      }
+    }
+  }
+
+  void grow(index_type index);
+
+  std::pmr::vector<std::pmr::vector<uint64_t>> m_layers;
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef YACS_MEMORY_RESOURCE_H
+#define YACS_MEMORY_RESOURCE_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace yacs {
+
+constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+constexpr size_t ARENA_BLOCK_SIZE = size_t(16) << 20;
+
+// new and delete over a resource. The memory is released with the static
+// type's size, so polymorphic objects free themselves through a virtual
+// member that calls delete_object with their own type.
+template <typename T, typename... Args>
+T* new_object(std::pmr::memory_resource* resource, Args&&... args) {
+  std::pmr::polymorphic_allocator<T> allocator(resource);
+  auto* object = allocator.allocate(1);
+  try {
+    return new (object) T(std::forward<Args>(args)...);
+  } catch (...) {
+    allocator.deallocate(object, 1);
+    throw;
+  }
+}
+
+template <typename T>
+void delete_object(std::pmr::memory_resource* resource, T* object) {
+  std::pmr::polymorphic_allocator<T> allocator(resource);
+  object->~T();
+  allocator.deallocate(object, 1);
+}
+
+// unique_ptr deleter for objects from new_object.
+template <typename T>
+struct resource_deleter {
+  std::pmr::memory_resource* resource = nullptr;
+  void operator()(T* object) const { delete_object(resource, object); }
+};
+
+template <typename T>
+using resource_ptr = std::unique_ptr<T, resource_deleter<T>>;
+
+// Maps allocations of at least HUGE_PAGE_SIZE bytes straight from the OS,
+// rounded up to whole huge pages. MAP_HUGETLB is tried first; without
+// reserved huge pages the mapping falls back to regular pages advised for
+// transparent huge pages. Smaller allocations go to the upstream resource.
+class huge_page_resource : public std::pmr::memory_resource {
+ public:
+  explicit huge_page_resource(
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : m_upstream(upstream) {}
+
+  static huge_page_resource& shared();
+
+ protected:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource* m_upstream;
+};
+
+// Monotonic arena, over huge pages by default. Deallocation is a no-op and
+// release() hands every block back at once, so a whole world can be dropped
+// between levels or runs. Pools that grow repeatedly leave their old
+// buffers behind until then, so reserve big pools up front. Registries
+// using the arena must be destroyed before release().
+class arena : public std::pmr::monotonic_buffer_resource {
+ public:
+  explicit arena(size_t initial_size = ARENA_BLOCK_SIZE,
+                 std::pmr::memory_resource* upstream =
+                     &huge_page_resource::shared())
+      : monotonic_buffer_resource(initial_size, upstream) {}
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef YACS_OBSERVER_H
+#define YACS_OBSERVER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "pool.hpp"
+#include "registry.hpp"
+#include "signal.hpp"
+#include "types.hpp"
+
+using std::vector;
+
+namespace yacs {
+
+// Collects the entities touched by the pool events it subscribes to, each
+// entity at most once, until clear(). Ids are recorded when the event fires,
+// so an entity destroyed afterwards shows up with its old version and fails
+// registry::valid().
+class observer {
+ public:
+  explicit observer(registry& registry) : m_registry(&registry) {}
+  ~observer();
+
+  template <typename T>
+  observer& on_construct() {
+    return connect(m_registry->on_construct<T>());
+  }
+
+  template <typename T>
+  observer& on_update() {
+    return connect(m_registry->on_update<T>());
+  }
+
+  template <typename T>
+  observer& on_destroy() {
+    return connect(m_registry->on_destroy<T>());
+  }
+
+  template <typename Fn>
+  void each(Fn fn) const {
+    for (size_t i = 0; i < m_entities.size(); ++i) {
+      fn(m_entities.raw()[i]);
+    }
+  }
+
+  bool contains(entity_id id) const;
+  size_t size() const { return m_entities.size(); }
+  bool empty() const { return m_entities.empty(); }
+  void clear();
+  void disconnect();
+
+ protected:
+  struct subscription {
+    signal<pool::index_type>* source;
+    signal<pool::index_type>::connection id;
+  };
+
+  observer& connect(signal<pool::index_type>& source);
+  void collect(pool::index_type index);
+
+  observer(const observer& other) = delete;
+  observer& operator=(const observer& other) = delete;
+
+  registry* m_registry;
+  vector<subscription> m_subscriptions;
+  packed_pool<entity_id> m_entities;
+};
+
+}  // namespace yacs
+
+#endif
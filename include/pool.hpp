@@ -2,52 +2,183 @@
 #define YACS_POOL_H
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdint>
 #include <functional>
-#include <tuple>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "hierarchical_bitset.hpp"
+#include "memory_resource.hpp"
 #include "pool_iterator.hpp"
+#include "radix_sort.hpp"
+#include "signal.hpp"
+#include "thread_pool.hpp"
 
 using std::forward;
-using std::forward_as_tuple;
 using std::function;
-using std::get;
-using std::pair;
-using std::piecewise_construct;
 using std::swap;
 using std::vector;
 
 namespace yacs {
 
+constexpr size_t SPARSE_PAGE_SIZE = 4096;
+
+template <size_t N>
+constexpr std::array<size_t, N> make_unallocated_page() {
+  std::array<size_t, N> page{};
+  for (auto& entry : page) {
+    entry = static_cast<size_t>(-1);
+  }
+  return page;
+}
+
+inline constexpr std::array<size_t, SPARSE_PAGE_SIZE> UNALLOCATED_PAGE =
+    make_unallocated_page<SPARSE_PAGE_SIZE>();
+
 class pool {
  public:
   using index_type = size_t;
+  using tick_type = std::uint32_t;
   virtual ~pool() = default;
   virtual void destroy(index_type index) = 0;
+  // Destroys every listed element; each must be present and listed once.
+  virtual void destroy(const index_type* indices, size_t n) = 0;
+  virtual bool contains(index_type index) const = 0;
+  // Moves the element at sources[i] into target, a pool of the same type,
+  // under targets[i].
+  virtual void transfer(pool& target, const index_type* sources,
+                        const index_type* targets, size_t n) = 0;
+  // Allocates an empty pool of the same type from resource. dispose()
+  // destroys a pool allocated from resource and frees its memory there.
+  virtual pool* create_empty(std::pmr::memory_resource* resource) const = 0;
+  virtual void dispose(std::pmr::memory_resource* resource) = 0;
+
+  // Stamped into the added and changed ticks of pools that track them.
+  void set_tick(tick_type tick) { m_tick = tick; }
+  tick_type tick() const { return m_tick; }
+
+ protected:
+  tick_type m_tick = 1;
+};
+
+// Listeners receive the sparse index. Construct fires after the value is
+// in place and destroy fires while it is still accessible.
+struct pool_signals {
+  explicit pool_signals(std::pmr::memory_resource* resource)
+      : construct(resource), update(resource), destroy(resource) {}
+
+  signal<pool::index_type> construct;
+  signal<pool::index_type> update;
+  signal<pool::index_type> destroy;
+};
+
+// Empty marker types are tags: their pools keep only the packed and sparse
+// indices, and every element shares one instance.
+template <typename T>
+inline constexpr bool is_tag_v =
+    std::is_empty_v<T> && std::is_default_constructible_v<T>;
+
+// Value column of tag pools. It only counts elements; construction
+// arguments still build a T so constructors run, but nothing is kept.
+template <typename T>
+class tag_column {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+
+  explicit tag_column(std::pmr::memory_resource* = nullptr)
+      : m_size(0), m_capacity(0) {}
+  tag_column(const tag_column& other, std::pmr::memory_resource*)
+      : m_size(other.m_size), m_capacity(other.m_capacity) {}
+  tag_column(const tag_column& other) = default;
+  tag_column(tag_column&& other)
+      : m_size(other.m_size), m_capacity(other.m_capacity) {
+    other.m_size = 0;
+    other.m_capacity = 0;
+  }
+
+  tag_column& operator=(const tag_column& other) = default;
+  tag_column& operator=(tag_column&& other) {
+    m_size = other.m_size;
+    m_capacity = std::max(m_capacity, other.m_capacity);
+    other.m_size = 0;
+    return *this;
+  }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    static_cast<void>(T(forward<Args>(args)...));
+    ++m_size;
+    return m_value;
+  }
+
+  template <typename It>
+  void assign(It first, It last) {
+    m_size = static_cast<size_type>(std::distance(first, last));
+    m_capacity = std::max(m_capacity, m_size);
+  }
+
+  void pop_back() { --m_size; }
+  void clear() { m_size = 0; }
+  void reserve(size_type n) { m_capacity = std::max(m_capacity, n); }
+
+  T& back() { return m_value; }
+  T& operator[](size_type) { return m_value; }
+  const T& operator[](size_type) const { return m_value; }
+  T* data() { return &m_value; }
+  const T* data() const { return &m_value; }
+  size_type size() const { return m_size; }
+  size_type capacity() const { return m_capacity; }
+
+ protected:
+  T m_value;
+  size_type m_size;
+  size_type m_capacity;
 };
 
+// Element i of a pool's raw() column; tag pools hand out a single instance.
+template <typename T>
+inline T& column_at(T* values, size_t i) {
+  if constexpr (is_tag_v<std::remove_const_t<T>>) {
+    return *values;
+  } else {
+    return values[i];
+  }
+}
+
 template <typename T>
 class packed_pool : public pool {
  public:
   using index_type = size_t;
-  using packed_value_type = pair<index_type, T>;
-  using size_type = typename std::vector<packed_value_type>::size_type;
-  using value_iterator = packed_value_iterator<index_type, T>;
+  using size_type = typename std::vector<T>::size_type;
+  using values_type =
+      std::conditional_t<is_tag_v<T>, tag_column<T>, std::pmr::vector<T>>;
+  using value_iterator = packed_value_iterator<index_type, T, values_type>;
   using reverse_value_iterator = std::reverse_iterator<value_iterator>;
 
-  using const_packed_iterator = const_packed_iterator<index_type, T>;
+  using const_packed_iterator =
+      yacs::const_packed_iterator<index_type, T, values_type>;
   using const_reverse_packed_iterator =
       std::reverse_iterator<const_packed_iterator>;
 
-  using const_sparse_iterator = const_sparse_iterator<index_type, T>;
+  using const_sparse_iterator = yacs::const_sparse_iterator<index_type, T>;
   using const_reverse_sparse_iterator =
       std::reverse_iterator<const_sparse_iterator>;
 
   static constexpr size_type DEFAULT_CAPACITY = 8192;
   static constexpr size_type UNALLOCATED_INDEX = static_cast<size_type>(-1);
+  // Sorts that find at most size() / ADAPTIVE_SORT_DIVISOR elements out of
+  // place merge them back instead of sorting everything.
+  static constexpr size_type ADAPTIVE_SORT_DIVISOR = 16;
 
   packed_pool();
+  explicit packed_pool(std::pmr::memory_resource* resource);
   packed_pool(packed_pool&& other);
   packed_pool(const packed_pool& other);
   virtual ~packed_pool();
@@ -58,10 +189,30 @@ class packed_pool : public pool {
   template <typename... Args>
   T& construct(index_type sparse_index, Args&&... args);
 
-  void destroy(index_type sparse_index) override;
+  void destroy(index_type sparse_index) final;
+  void destroy(const index_type* indices, size_type n) final;
   void destroy();
 
-  inline bool contains(index_type sparse_index) const;
+  void assign(const index_type* indices, const T* values, size_type n);
+  void transfer(pool& target, const index_type* sources,
+                const index_type* targets, size_type n) final;
+  pool* create_empty(std::pmr::memory_resource* resource) const final {
+    return new_object<packed_pool>(resource, resource);
+  }
+  void dispose(std::pmr::memory_resource* resource) final {
+    delete_object(resource, this);
+  }
+
+  template <typename Fn>
+  T& patch(index_type sparse_index, Fn fn);
+  template <typename... Args>
+  T& replace(index_type sparse_index, Args&&... args);
+
+  inline bool contains(index_type sparse_index) const final;
+
+  inline size_type packed_index(index_type sparse_index) const;
+  inline index_type sparse_index(size_type packed_index) const;
+  void swap_elements(index_type lhs, index_type rhs);
 
   inline T& access(index_type sparse_index);
   inline T& operator[](index_type sparse_index);
@@ -72,6 +223,29 @@ class packed_pool : public pool {
   inline size_type capacity() const;
   inline bool empty() const;
   inline void reserve(size_type n);
+  inline void grow(size_type n);
+  inline void reserve_sparse(index_type sparse_index);
+
+  void track_presence();
+
+  void track_ticks();
+  bool tracks_ticks() const { return m_track_ticks; }
+  inline tick_type added_tick(index_type sparse_index) const;
+  inline tick_type changed_tick(index_type sparse_index) const;
+  inline void touch(index_type sparse_index);
+  // Stamps packed positions [first, last) for iteration that hands out
+  // mutable references without going through access().
+  inline void touch_packed(size_type first, size_type last);
+  const hierarchical_bitset* presence() const { return m_presence.get(); }
+  std::pmr::memory_resource* resource() const { return m_resource; }
+
+  signal<index_type>& on_construct() { return signals().construct; }
+  signal<index_type>& on_update() { return signals().update; }
+  signal<index_type>& on_destroy() { return signals().destroy; }
+
+  inline const index_type* data() const;
+  inline T* raw();
+  inline const T* raw() const;
 
   value_iterator begin();
   value_iterator end();
@@ -88,118 +262,604 @@ class packed_pool : public pool {
   const_reverse_sparse_iterator rsparse_begin() const;
   const_reverse_sparse_iterator rsparse_end() const;
 
+  template <typename Fn>
+  void parallel_each(Fn fn);
+  template <typename Fn, typename Executor>
+  void parallel_each(Fn fn, Executor& executor);
+
   void sort();
-  void sort(function<bool(const T&, const T&)> comparator);
+  template <typename Compare>
+  void sort(Compare comparator);
+  template <typename Projection>
+  void sort_by(Projection projection);
   void sort(const_sparse_iterator it, const_sparse_iterator end);
 
  protected:
   T& internal_access(index_type sparse_index) {
-    assert(sparse_index < m_sparse.size());
-    assert(m_sparse[sparse_index] != UNALLOCATED_INDEX);
-    return get<1>(m_packed[m_sparse[sparse_index]]);
+    assert(contains(sparse_index));
+    return m_values[sparse(sparse_index)];
   }
 
   const T& internal_access(index_type sparse_index) const {
-    assert(sparse_index < m_sparse.size());
-    assert(m_sparse[sparse_index] != UNALLOCATED_INDEX);
-    return get<1>(m_packed[m_sparse[sparse_index]]);
+    assert(contains(sparse_index));
+    return m_values[sparse(sparse_index)];
+  }
+
+  inline index_type& sparse(index_type sparse_index) {
+    return m_sparse[sparse_index / SPARSE_PAGE_SIZE]
+                   [sparse_index % SPARSE_PAGE_SIZE];
+  }
+
+  inline const index_type& sparse(index_type sparse_index) const {
+    return m_sparse[sparse_index / SPARSE_PAGE_SIZE]
+                   [sparse_index % SPARSE_PAGE_SIZE];
+  }
+
+  // destroy() without the signal.
+  void erase(index_type sparse_index);
+  void erase();
+  // Removes the elements at the ascending packed positions.
+  void erase_packed(const vector<size_type>& positions);
+
+  inline index_type& assure_sparse(index_type sparse_index) {
+    auto page = sparse_index / SPARSE_PAGE_SIZE;
+    if (page >= m_sparse.size()) {
+      m_sparse.resize(page + 1, unallocated_page());
+    }
+    if (m_sparse[page] == unallocated_page()) {
+      m_sparse[page] = allocate_page();
+      std::copy(UNALLOCATED_PAGE.begin(), UNALLOCATED_PAGE.end(),
+                m_sparse[page]);
+    }
+    return m_sparse[page][sparse_index % SPARSE_PAGE_SIZE];
+  }
+
+  static index_type* unallocated_page() {
+    return const_cast<index_type*>(UNALLOCATED_PAGE.data());
+  }
+
+  index_type* allocate_page() {
+    return static_cast<index_type*>(m_resource->allocate(
+        SPARSE_PAGE_SIZE * sizeof(index_type), alignof(index_type)));
+  }
+
+  void copy_pages(const std::pmr::vector<index_type*>& pages) {
+    m_sparse.assign(pages.size(), unallocated_page());
+    for (size_type i = 0; i < pages.size(); ++i) {
+      if (pages[i] != unallocated_page()) {
+        m_sparse[i] = allocate_page();
+        std::copy(pages[i], pages[i] + SPARSE_PAGE_SIZE, m_sparse[i]);
+      }
+    }
+  }
+
+  void release_pages() {
+    for (auto page : m_sparse) {
+      if (page != unallocated_page()) {
+        m_resource->deallocate(page, SPARSE_PAGE_SIZE * sizeof(index_type),
+                               alignof(index_type));
+      }
+    }
+    m_sparse.clear();
   }
 
-  inline void fix_indices() {
-    for (size_type i = 0; i < m_packed.size(); ++i) {
-      m_sparse[m_packed[i].first] = i;
+  inline void swap_packed(size_type lhs, size_type rhs) {
+    swap(m_packed[lhs], m_packed[rhs]);
+    if constexpr (!is_tag_v<T>) {
+      swap(m_values[lhs], m_values[rhs]);
+    }
+    if (m_track_ticks) {
+      swap(m_added[lhs], m_added[rhs]);
+      swap(m_changed[lhs], m_changed[rhs]);
     }
   }
 
-  vector<pair<index_type, T>> m_packed;
-  vector<index_type> m_sparse;
+  template <typename Less>
+  bool sort_adaptive(Less less);
+  void permute(const vector<size_type>& order);
+
+  // Allocated on first subscription so pools nobody listens to only pay a
+  // null check per construct and destroy.
+  pool_signals& signals() {
+    if (!m_signals) {
+      m_signals = make_owned<pool_signals>(m_resource);
+    }
+    return *m_signals;
+  }
+
+  // An object owned by this pool and allocated from m_resource.
+  template <typename U, typename... Args>
+  resource_ptr<U> make_owned(Args&&... args) {
+    return resource_ptr<U>(new_object<U>(m_resource, forward<Args>(args)...),
+                           resource_deleter<U>{m_resource});
+  }
+
+  // Every column, sparse page, presence bit and signal comes from
+  // m_resource. Copies use the default resource and assignment keeps the
+  // target's, as with std::pmr containers.
+  std::pmr::memory_resource* m_resource;
+  std::pmr::vector<index_type> m_packed;
+  values_type m_values;
+  std::pmr::vector<index_type*> m_sparse;
+  resource_ptr<hierarchical_bitset> m_presence;
+  resource_ptr<pool_signals> m_signals;
+  std::pmr::vector<tick_type> m_added;
+  std::pmr::vector<tick_type> m_changed;
+  bool m_track_ticks = false;
 };
 
 template <typename T>
-packed_pool<T>::packed_pool() {
-  m_packed.reserve(DEFAULT_CAPACITY);
+packed_pool<T>::packed_pool()
+    : packed_pool(std::pmr::get_default_resource()) {}
+
+template <typename T>
+packed_pool<T>::packed_pool(std::pmr::memory_resource* resource)
+    : m_resource(resource),
+      m_packed(resource),
+      m_values(resource),
+      m_sparse(resource),
+      m_added(resource),
+      m_changed(resource) {
+  reserve(DEFAULT_CAPACITY);
 }
 
 template <typename T>
 packed_pool<T>::packed_pool(packed_pool&& other)
-    : m_packed(move(other.m_packed)), m_sparse(move(other.m_sparse)) {}
+    : m_resource(other.m_resource),
+      m_packed(move(other.m_packed)),
+      m_values(move(other.m_values)),
+      m_sparse(move(other.m_sparse)),
+      m_presence(move(other.m_presence)),
+      m_signals(move(other.m_signals)),
+      m_added(move(other.m_added)),
+      m_changed(move(other.m_changed)),
+      m_track_ticks(other.m_track_ticks) {
+  m_tick = other.m_tick;
+  other.m_sparse.clear();
+}
 
 template <typename T>
 packed_pool<T>::packed_pool(const packed_pool& other)
-    : m_packed(other.m_packed), m_sparse(other.m_sparse) {}
+    : m_resource(std::pmr::get_default_resource()),
+      m_packed(other.m_packed, m_resource),
+      m_values(other.m_values, m_resource),
+      m_sparse(m_resource),
+      m_added(other.m_added, m_resource),
+      m_changed(other.m_changed, m_resource),
+      m_track_ticks(other.m_track_ticks) {
+  m_tick = other.m_tick;
+  copy_pages(other.m_sparse);
+  if (other.m_presence) {
+    m_presence = make_owned<hierarchical_bitset>(*other.m_presence, m_resource);
+  }
+}
 
 template <typename T>
-packed_pool<T>::~packed_pool() {}
+packed_pool<T>::~packed_pool() {
+  release_pages();
+}
 
 template <typename T>
 packed_pool<T>& packed_pool<T>::operator=(const packed_pool& other) {
-  m_packed = other.m_packed;
-  m_sparse = other.m_sparse;
+  if (this != &other) {
+    m_packed = other.m_packed;
+    m_values = other.m_values;
+    release_pages();
+    copy_pages(other.m_sparse);
+    m_presence.reset();
+    if (other.m_presence) {
+      m_presence =
+          make_owned<hierarchical_bitset>(*other.m_presence, m_resource);
+    }
+    m_added = other.m_added;
+    m_changed = other.m_changed;
+    m_track_ticks = other.m_track_ticks;
+    m_tick = other.m_tick;
+  }
   return *this;
 }
 
 template <typename T>
 packed_pool<T>& packed_pool<T>::operator=(packed_pool&& other) {
+  // Buffers from another resource are copied rather than adopted.
   m_packed = move(other.m_packed);
-  m_sparse = move(other.m_sparse);
+  m_values = move(other.m_values);
+  m_added = move(other.m_added);
+  m_changed = move(other.m_changed);
+  release_pages();
+  if (m_resource == other.m_resource) {
+    swap(m_sparse, other.m_sparse);
+    m_presence = move(other.m_presence);
+  } else {
+    copy_pages(other.m_sparse);
+    other.release_pages();
+    other.m_packed.clear();
+    other.m_values.clear();
+    other.m_added.clear();
+    other.m_changed.clear();
+    m_presence.reset();
+    if (other.m_presence) {
+      m_presence =
+          make_owned<hierarchical_bitset>(*other.m_presence, m_resource);
+      other.m_presence.reset();
+    }
+  }
+  // Signals are adopted either way, so connections to them stay valid; the
+  // deleter frees them on their own resource.
+  m_signals = move(other.m_signals);
+  m_track_ticks = other.m_track_ticks;
+  m_tick = other.m_tick;
   return *this;
 }
 
 template <typename T>
 template <typename... Args>
 T& packed_pool<T>::construct(index_type sparse_index, Args&&... args) {
-  if (sparse_index >= m_sparse.size()) {
-    m_sparse.resize(sparse_index + 1, UNALLOCATED_INDEX);
+  auto& entry = assure_sparse(sparse_index);
+  assert(entry == UNALLOCATED_INDEX);
+  m_values.emplace_back(forward<Args>(args)...);
+  entry = m_packed.size();
+  m_packed.push_back(sparse_index);
+  if (m_presence) {
+    m_presence->set(sparse_index);
+  }
+  if (m_track_ticks) {
+    m_added.push_back(m_tick);
+    m_changed.push_back(m_tick);
+  }
+  if (m_signals) {
+    m_signals->construct.publish(sparse_index);
+    return internal_access(sparse_index);
   }
-  assert(m_sparse[sparse_index] == UNALLOCATED_INDEX);
-  index_type packed_index = m_packed.size();
-  m_sparse[sparse_index] = packed_index;
-  m_packed.emplace_back(piecewise_construct, forward_as_tuple(sparse_index),
-                        forward_as_tuple(forward<Args>(args)...));
 
-  return get<1>(m_packed[packed_index]);
+  return m_values.back();
 }
 
 template <typename T>
 void packed_pool<T>::destroy(index_type sparse_index) {
-  assert(sparse_index < m_sparse.size());
-  assert(m_sparse[sparse_index] != UNALLOCATED_INDEX);
+  assert(contains(sparse_index));
+  if (m_signals) {
+    m_signals->destroy.publish(sparse_index);
+  }
+  erase(sparse_index);
+}
 
-  index_type packed_index = m_sparse[sparse_index];
+template <typename T>
+void packed_pool<T>::erase(index_type sparse_index) {
+  index_type packed_index = sparse(sparse_index);
   index_type last_packed_index = m_packed.size() - 1;
-  index_type last_sparse_index = get<0>(m_packed[last_packed_index]);
+  index_type last_sparse_index = m_packed[last_packed_index];
 
-  m_sparse[last_sparse_index] = packed_index;
-  m_sparse[sparse_index] = UNALLOCATED_INDEX;
+  sparse(last_sparse_index) = packed_index;
+  sparse(sparse_index) = UNALLOCATED_INDEX;
   if (packed_index != last_packed_index) {
-    swap(m_packed[packed_index], m_packed[last_packed_index]);
+    swap_packed(packed_index, last_packed_index);
   }
   m_packed.pop_back();
+  m_values.pop_back();
+  if (m_track_ticks) {
+    m_added.pop_back();
+    m_changed.pop_back();
+  }
+  if (m_presence) {
+    m_presence->reset(sparse_index);
+  }
+}
+
+// Every signal goes out before the first element moves, so listeners see
+// the values of all the elements being destroyed. Destroying all of them
+// clears the pool instead of swapping each one out.
+template <typename T>
+void packed_pool<T>::destroy(const index_type* indices, size_type n) {
+  if (m_signals) {
+    for (size_type i = 0; i < n; ++i) {
+      assert(contains(indices[i]));
+      m_signals->destroy.publish(indices[i]);
+    }
+  }
+  if (n == size()) {
+    erase();
+    return;
+  }
+  for (size_type i = 0; i < n; ++i) {
+    erase(indices[i]);
+  }
 }
 
 template <typename T>
 void packed_pool<T>::destroy() {
-  for (size_type i = 0; i < m_sparse.size(); ++i) {
-    if (m_sparse[i] != UNALLOCATED_INDEX) {
-      destroy(i);
+  if (m_signals) {
+    for (auto sparse_index : m_packed) {
+      m_signals->destroy.publish(sparse_index);
+    }
+  }
+  erase();
+}
+
+template <typename T>
+void packed_pool<T>::erase() {
+  for (auto sparse_index : m_packed) {
+    sparse(sparse_index) = UNALLOCATED_INDEX;
+  }
+  m_packed.clear();
+  m_values.clear();
+  m_added.clear();
+  m_changed.clear();
+  if (m_presence) {
+    m_presence->clear();
+  }
+}
+
+// Replaces the contents with n elements in the given packed order. Trivially
+// copyable values are copied as one block.
+template <typename T>
+void packed_pool<T>::assign(const index_type* indices, const T* values,
+                            size_type n) {
+  destroy();
+  m_packed.assign(indices, indices + n);
+  m_values.assign(values, values + n);
+  for (size_type i = 0; i < n; ++i) {
+    assure_sparse(m_packed[i]) = i;
+  }
+  if (m_track_ticks) {
+    m_added.assign(n, m_tick);
+    m_changed.assign(n, m_tick);
+  }
+  if (m_presence) {
+    for (auto sparse_index : m_packed) {
+      m_presence->set(sparse_index);
+    }
+  }
+  if (m_signals) {
+    for (auto sparse_index : m_packed) {
+      m_signals->construct.publish(sparse_index);
+    }
+  }
+}
+
+// The moved elements are appended to target as one block: in source order
+// for a whole pool, as merge() does, and otherwise in packed order, so the
+// value column is read forwards and runs of neighbours are copied
+// bytewise for trivially copyable T. Destroy listeners run before anything
+// moves, while the values are intact, and construct listeners once every
+// value is in place.
+template <typename T>
+void packed_pool<T>::transfer(pool& target, const index_type* sources,
+                              const index_type* targets, size_type n) {
+  auto& other = static_cast<packed_pool&>(target);
+  other.grow(n);
+  if (m_signals) {
+    for (size_type i = 0; i < n; ++i) {
+      m_signals->destroy.publish(sources[i]);
+    }
+  }
+
+  auto first = other.m_packed.size();
+  other.m_packed.resize(first + n);
+  if (n == size()) {
+    for (size_type i = 0; i < n; ++i) {
+      auto position = first + sparse(sources[i]);
+      other.m_packed[position] = targets[i];
+      other.assure_sparse(targets[i]) = position;
+    }
+    if constexpr (is_tag_v<T>) {
+      for (size_type i = 0; i < n; ++i) {
+        other.m_values.emplace_back();
+      }
+    } else if constexpr (std::is_trivially_copyable_v<T>) {
+      other.m_values.insert(other.m_values.end(), m_values.begin(),
+                            m_values.end());
+    } else {
+      for (auto& value : m_values) {
+        other.m_values.emplace_back(std::move(value));
+      }
+    }
+    erase();
+  } else {
+    vector<decltype(radix_key(size_type()))> keys(n);
+    vector<size_type> order(n);
+    for (size_type i = 0; i < n; ++i) {
+      keys[i] = radix_key(sparse(sources[i]));
+      order[i] = i;
+    }
+    radix_sort(keys, order);
+    vector<size_type> positions(n);
+    for (size_type j = 0; j < n; ++j) {
+      positions[j] = sparse(sources[order[j]]);
+      other.m_packed[first + j] = targets[order[j]];
+      other.assure_sparse(targets[order[j]]) = first + j;
     }
+    if constexpr (is_tag_v<T>) {
+      for (size_type j = 0; j < n; ++j) {
+        other.m_values.emplace_back();
+      }
+    } else if constexpr (std::is_trivially_copyable_v<T>) {
+      for (size_type j = 0; j < n;) {
+        size_type run = 1;
+        while (j + run < n && positions[j + run] == positions[j] + run) {
+          ++run;
+        }
+        auto begin = m_values.begin() + positions[j];
+        other.m_values.insert(other.m_values.end(), begin, begin + run);
+        j += run;
+      }
+    } else {
+      for (auto position : positions) {
+        other.m_values.emplace_back(std::move(m_values[position]));
+      }
+    }
+    erase_packed(positions);
+  }
+
+  if (other.m_track_ticks) {
+    other.m_added.resize(first + n, other.m_tick);
+    other.m_changed.resize(first + n, other.m_tick);
+  }
+  if (other.m_presence) {
+    for (size_type i = 0; i < n; ++i) {
+      other.m_presence->set(targets[i]);
+    }
+  }
+  if (other.m_signals) {
+    for (size_type i = first; i < first + n; ++i) {
+      other.m_signals->construct.publish(other.m_packed[i]);
+    }
+  }
+}
+
+// Survivors in the last positions.size() slots fill the holes left below
+// them, in one pass, and the tail is then dropped.
+template <typename T>
+void packed_pool<T>::erase_packed(const vector<size_type>& positions) {
+  auto kept = m_packed.size() - positions.size();
+  for (auto position : positions) {
+    sparse(m_packed[position]) = UNALLOCATED_INDEX;
+    if (m_presence) {
+      m_presence->reset(m_packed[position]);
+    }
+  }
+  auto tail = kept;
+  for (size_type j = 0; j < positions.size() && positions[j] < kept; ++j) {
+    while (sparse(m_packed[tail]) == UNALLOCATED_INDEX) {
+      ++tail;
+    }
+    auto hole = positions[j];
+    m_packed[hole] = m_packed[tail];
+    sparse(m_packed[hole]) = hole;
+    if constexpr (!is_tag_v<T>) {
+      swap(m_values[hole], m_values[tail]);
+    }
+    if (m_track_ticks) {
+      m_added[hole] = m_added[tail];
+      m_changed[hole] = m_changed[tail];
+    }
+    ++tail;
+  }
+  m_packed.resize(kept);
+  while (m_values.size() > kept) {
+    m_values.pop_back();
+  }
+  if (m_track_ticks) {
+    m_added.resize(kept);
+    m_changed.resize(kept);
+  }
+}
+
+template <typename T>
+template <typename Fn>
+T& packed_pool<T>::patch(index_type sparse_index, Fn fn) {
+  auto& value = internal_access(sparse_index);
+  fn(value);
+  touch(sparse_index);
+  if (m_signals) {
+    m_signals->update.publish(sparse_index);
+  }
+  return value;
+}
+
+template <typename T>
+template <typename... Args>
+T& packed_pool<T>::replace(index_type sparse_index, Args&&... args) {
+  auto& value = internal_access(sparse_index);
+  value = T(forward<Args>(args)...);
+  touch(sparse_index);
+  if (m_signals) {
+    m_signals->update.publish(sparse_index);
+  }
+  return value;
+}
+
+template <typename T>
+void packed_pool<T>::track_presence() {
+  if (m_presence) {
+    return;
+  }
+  m_presence = make_owned<hierarchical_bitset>(m_resource);
+  for (auto sparse_index : m_packed) {
+    m_presence->set(sparse_index);
+  }
+}
+
+// Elements already in the pool count as added and changed at the current
+// tick.
+template <typename T>
+void packed_pool<T>::track_ticks() {
+  if (m_track_ticks) {
+    return;
+  }
+  m_track_ticks = true;
+  m_added.assign(m_packed.size(), m_tick);
+  m_changed.assign(m_packed.size(), m_tick);
+}
+
+template <typename T>
+inline typename packed_pool<T>::tick_type packed_pool<T>::added_tick(
+    index_type sparse_index) const {
+  assert(m_track_ticks && contains(sparse_index));
+  return m_added[sparse(sparse_index)];
+}
+
+template <typename T>
+inline typename packed_pool<T>::tick_type packed_pool<T>::changed_tick(
+    index_type sparse_index) const {
+  assert(m_track_ticks && contains(sparse_index));
+  return m_changed[sparse(sparse_index)];
+}
+
+template <typename T>
+inline void packed_pool<T>::touch(index_type sparse_index) {
+  if (m_track_ticks) {
+    m_changed[sparse(sparse_index)] = m_tick;
+  }
+}
+
+template <typename T>
+inline void packed_pool<T>::touch_packed(size_type first, size_type last) {
+  if (m_track_ticks) {
+    std::fill(m_changed.begin() + first, m_changed.begin() + last, m_tick);
   }
 }
 
 template <typename T>
 inline bool packed_pool<T>::contains(index_type sparse_index) const {
-  return sparse_index < m_sparse.size() &&
-         m_sparse[sparse_index] != UNALLOCATED_INDEX;
+  auto page = sparse_index / SPARSE_PAGE_SIZE;
+  return page < m_sparse.size() &&
+         m_sparse[page][sparse_index % SPARSE_PAGE_SIZE] != UNALLOCATED_INDEX;
+}
+
+template <typename T>
+inline typename packed_pool<T>::size_type packed_pool<T>::packed_index(
+    index_type sparse_index) const {
+  assert(contains(sparse_index));
+  return sparse(sparse_index);
+}
+
+template <typename T>
+inline typename packed_pool<T>::index_type packed_pool<T>::sparse_index(
+    size_type packed_index) const {
+  assert(packed_index < m_packed.size());
+  return m_packed[packed_index];
+}
+
+template <typename T>
+void packed_pool<T>::swap_elements(index_type lhs, index_type rhs) {
+  assert(contains(lhs) && contains(rhs));
+  swap_packed(sparse(lhs), sparse(rhs));
+  swap(sparse(lhs), sparse(rhs));
 }
 
 template <typename T>
 inline T& packed_pool<T>::access(index_type sparse_index) {
-  return internal_access(sparse_index);
+  auto& value = internal_access(sparse_index);
+  touch(sparse_index);
+  return value;
 }
 
 template <typename T>
 inline T& packed_pool<T>::operator[](index_type sparse_index) {
-  return internal_access(sparse_index);
+  auto& value = internal_access(sparse_index);
+  touch(sparse_index);
+  return value;
 }
 
 template <typename T>
@@ -219,7 +879,7 @@ inline typename packed_pool<T>::size_type packed_pool<T>::size() const {
 
 template <typename T>
 inline typename packed_pool<T>::size_type packed_pool<T>::capacity() const {
-  return m_packed.capacity();
+  return m_values.capacity();
 }
 
 template <typename T>
@@ -230,16 +890,55 @@ inline bool packed_pool<T>::empty() const {
 template <typename T>
 inline void packed_pool<T>::reserve(size_type n) {
   m_packed.reserve(n);
+  m_values.reserve(n);
+  if (m_track_ticks) {
+    m_added.reserve(n);
+    m_changed.reserve(n);
+  }
+}
+
+template <typename T>
+inline void packed_pool<T>::grow(size_type n) {
+  auto needed = size() + n;
+  if (needed > capacity()) {
+    reserve(std::max(needed, capacity() * 2));
+  }
+}
+
+template <typename T>
+inline void packed_pool<T>::reserve_sparse(index_type sparse_index) {
+  auto pages = sparse_index / SPARSE_PAGE_SIZE + 1;
+  if (pages > m_sparse.size()) {
+    m_sparse.resize(pages, unallocated_page());
+  }
+}
+
+template <typename T>
+inline const typename packed_pool<T>::index_type* packed_pool<T>::data()
+    const {
+  return m_packed.data();
+}
+
+template <typename T>
+inline T* packed_pool<T>::raw() {
+  return m_values.data();
+}
+
+template <typename T>
+inline const T* packed_pool<T>::raw() const {
+  return m_values.data();
 }
 
+// Mutable iteration may write any element, so it counts as a change to all.
 template <typename T>
 typename packed_pool<T>::value_iterator packed_pool<T>::begin() {
-  return value_iterator(&m_packed);
+  touch_packed(0, size());
+  return value_iterator(&m_values);
 }
 
 template <typename T>
 typename packed_pool<T>::value_iterator packed_pool<T>::end() {
-  return value_iterator(&m_packed, m_packed.size());
+  return value_iterator(&m_values, m_values.size());
 }
 
 template <typename T>
@@ -255,13 +954,13 @@ typename packed_pool<T>::reverse_value_iterator packed_pool<T>::rend() {
 template <typename T>
 typename packed_pool<T>::const_packed_iterator packed_pool<T>::packed_begin()
     const {
-  return const_packed_iterator(&m_packed);
+  return const_packed_iterator(&m_packed, &m_values);
 }
 
 template <typename T>
 typename packed_pool<T>::const_packed_iterator packed_pool<T>::packed_end()
     const {
-  return const_packed_iterator(&m_packed, m_packed.size());
+  return const_packed_iterator(&m_packed, &m_values, m_packed.size());
 }
 
 template <typename T>
@@ -301,18 +1000,93 @@ packed_pool<T>::rsparse_end() const {
 }
 
 template <typename T>
-void packed_pool<T>::sort() {
-  std::sort(m_packed.begin(), m_packed.end(),
-            [](auto& left, auto& right) { return left.first < right.first; });
-  fix_indices();
+template <typename Fn>
+void packed_pool<T>::parallel_each(Fn fn) {
+  parallel_each(fn, thread_pool::shared());
 }
 
 template <typename T>
-void packed_pool<T>::sort(function<bool(const T&, const T&)> comparator) {
-  std::sort(m_packed.begin(), m_packed.end(), [&](auto& left, auto& right) {
-    return comparator(left.second, right.second);
+template <typename Fn, typename Executor>
+void packed_pool<T>::parallel_each(Fn fn, Executor& executor) {
+  auto* indices = m_packed.data();
+  auto* values = m_values.data();
+  auto grain = chunk_size<T>(size(), executor.concurrency());
+  executor.parallel_for(size(), grain, [&](size_t begin, size_t end) {
+    for (size_type i = begin; i < end; ++i) {
+      if constexpr (std::is_invocable_v<Fn&, index_type, T&>) {
+        fn(indices[i], column_at(values, i));
+      } else {
+        fn(column_at(values, i));
+      }
+    }
+    touch_packed(begin, end);
   });
-  fix_indices();
+}
+
+template <typename T>
+void packed_pool<T>::sort() {
+  if (sort_adaptive([this](size_type left, size_type right) {
+        return m_packed[left] < m_packed[right];
+      })) {
+    return;
+  }
+  vector<size_type> order(m_packed.size());
+  std::iota(order.begin(), order.end(), 0);
+  vector<index_type> keys(m_packed.begin(), m_packed.end());
+  radix_sort(keys, order);
+  permute(order);
+}
+
+template <typename T>
+template <typename Compare>
+void packed_pool<T>::sort(Compare comparator) {
+  auto less = [&](size_type left, size_type right) {
+    return comparator(m_values[left], m_values[right]);
+  };
+  if (sort_adaptive(less)) {
+    return;
+  }
+  vector<size_type> order(m_packed.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), less);
+  permute(order);
+}
+
+// Stable sort by projection(value). Keys are extracted once; arithmetic keys
+// are radix sorted, anything else is compared with operator<.
+template <typename T>
+template <typename Projection>
+void packed_pool<T>::sort_by(Projection projection) {
+  using key_type =
+      std::decay_t<std::invoke_result_t<Projection&, const T&>>;
+  vector<size_type> order(m_packed.size());
+  std::iota(order.begin(), order.end(), 0);
+  if constexpr (std::is_arithmetic_v<key_type>) {
+    vector<decltype(radix_key(key_type()))> keys(m_values.size());
+    for (size_type i = 0; i < keys.size(); ++i) {
+      keys[i] = radix_key(projection(std::as_const(m_values[i])));
+    }
+    if (sort_adaptive([&keys](size_type left, size_type right) {
+          return keys[left] < keys[right];
+        })) {
+      return;
+    }
+    radix_sort(keys, order);
+  } else {
+    vector<key_type> keys;
+    keys.reserve(m_values.size());
+    for (size_type i = 0; i < m_values.size(); ++i) {
+      keys.push_back(projection(std::as_const(m_values[i])));
+    }
+    auto less = [&keys](size_type left, size_type right) {
+      return keys[left] < keys[right];
+    };
+    if (sort_adaptive(less)) {
+      return;
+    }
+    std::stable_sort(order.begin(), order.end(), less);
+  }
+  permute(order);
 }
 
 template <typename T>
@@ -320,20 +1094,106 @@ void packed_pool<T>::sort(const_sparse_iterator it, const_sparse_iterator end) {
   size_type packed_cursor = 0;
   for (; it != end; ++it) {
     auto sparse_index = *it;
-    if (sparse_index >= m_sparse.size() ||
-        m_sparse[sparse_index] == UNALLOCATED_INDEX) {
+    if (!contains(sparse_index)) {
       continue;
     }
 
-    size_type sparse_cursor = m_packed[packed_cursor].first;
+    size_type sparse_cursor = m_packed[packed_cursor];
     if (sparse_index != sparse_cursor) {
-      size_type packed_index = m_sparse[sparse_index];
-      swap(m_packed[packed_cursor], m_packed[packed_index]);
-      swap(m_sparse[sparse_cursor], m_sparse[sparse_index]);
+      size_type packed_index = sparse(sparse_index);
+      swap_packed(packed_cursor, packed_index);
+      swap(sparse(sparse_cursor), sparse(sparse_index));
     }
     packed_cursor += 1;
   }
 }
 
+// Handles pools that are already close to sorted, e.g. re-sorted every
+// frame. Adjacent out-of-order pairs are pulled out, which leaves the rest
+// sorted with at most twice the minimal number of elements removed; those
+// are sorted on their own and merged back. Ties go by packed position so
+// the result is stable. Returns false without touching the pool when too
+// many elements are out of place.
+template <typename T>
+template <typename Less>
+bool packed_pool<T>::sort_adaptive(Less less) {
+  auto n = m_packed.size();
+  size_type first = 1;
+  while (first < n && !less(first, first - 1)) {
+    ++first;
+  }
+  if (first >= n) {
+    return true;
+  }
+
+  auto limit = n / ADAPTIVE_SORT_DIVISOR;
+  vector<size_type> kept(first);
+  vector<size_type> displaced;
+  std::iota(kept.begin(), kept.end(), 0);
+  kept.reserve(n);
+  for (auto i = first; i < n; ++i) {
+    if (!kept.empty() && less(i, kept.back())) {
+      displaced.push_back(kept.back());
+      displaced.push_back(i);
+      kept.pop_back();
+      if (displaced.size() > limit) {
+        return false;
+      }
+    } else {
+      kept.push_back(i);
+    }
+  }
+
+  auto before = [&less](size_type left, size_type right) {
+    return less(left, right) || (!less(right, left) && left < right);
+  };
+  std::sort(displaced.begin(), displaced.end(), before);
+  vector<size_type> order(n);
+  std::merge(kept.begin(), kept.end(), displaced.begin(), displaced.end(),
+             order.begin(), before);
+  permute(order);
+  return true;
+}
+
+// Reorders every column so that order[i] is the packed index that moves to
+// i. Only the range that actually moves is gathered, and only the sparse
+// entries of moved elements are rewritten.
+template <typename T>
+void packed_pool<T>::permute(const vector<size_type>& order) {
+  size_type first = 0;
+  size_type last = order.size();
+  while (first < last && order[first] == first) {
+    ++first;
+  }
+  while (last > first && order[last - 1] == last - 1) {
+    --last;
+  }
+
+  auto gather = [&](auto& column) {
+    using value_type = typename std::decay_t<decltype(column)>::value_type;
+    vector<value_type> moved;
+    moved.reserve(last - first);
+    for (auto i = first; i < last; ++i) {
+      moved.push_back(std::move(column[order[i]]));
+    }
+    for (auto i = first; i < last; ++i) {
+      swap(column[i], moved[i - first]);
+    }
+  };
+  gather(m_packed);
+  if constexpr (!is_tag_v<T>) {
+    gather(m_values);
+  }
+  if (m_track_ticks) {
+    gather(m_added);
+    gather(m_changed);
+  }
+  for (auto i = first; i < last; ++i) {
+    if (order[i] != i) {
+      sparse(m_packed[i]) = i;
+    }
+  }
+}
+
 }  // namespace yacs
 #endif
\ No newline at end of file
@@ -1,42 +1,41 @@
 #ifndef YACS_POOL_ITERATOR_H
 #define YACS_POOL_ITERATOR_H
 
+#include <memory_resource>
 #include <utility>
 #include <vector>
 
-using std::get;
 using std::pair;
 using std::swap;
 using std::vector;
 
 namespace yacs {
 
-template <typename I, typename T>
+// Values is the pool's value column; tag pools use one without storage.
+template <typename I, typename T, typename Values = std::pmr::vector<T>>
 class packed_value_iterator {
  public:
   using value_type = T;
-  using internal_value_type = pair<I, T>;
   using const_value_type = const T;
-  using size_type = typename std::vector<internal_value_type>::size_type;
+  using size_type = typename std::vector<value_type>::size_type;
   using pointer = value_type*;
   using const_pointer = const_value_type*;
   using reference = value_type&;
   using const_reference = const_value_type&;
-  using difference_type = typename std::vector<internal_value_type>::size_type;
+  using difference_type = typename std::vector<value_type>::size_type;
   using iterator_category = std::bidirectional_iterator_tag;
 
-  packed_value_iterator() : index(-1), packed(nullptr) {}
+  packed_value_iterator() : index(-1), values(nullptr) {}
 
-  packed_value_iterator(vector<internal_value_type>* packed,
-                        size_type index = 0)
-      : index(index), packed(packed) {}
+  packed_value_iterator(Values* values, size_type index = 0)
+      : index(index), values(values) {}
 
   packed_value_iterator(const packed_value_iterator& other)
-      : index(other.index), packed(other.packed) {}
+      : index(other.index), values(other.values) {}
 
   packed_value_iterator& operator=(packed_value_iterator other) {
     swap(index, other.index);
-    swap(packed, other.packed);
+    swap(values, other.values);
     return *this;
   }
 
@@ -63,46 +62,52 @@ class packed_value_iterator {
   }
 
   bool operator==(const packed_value_iterator& other) const {
-    return packed == other.packed && index == other.index;
+    return values == other.values && index == other.index;
   }
 
   bool operator!=(const packed_value_iterator& other) const {
     return !(*this == other);
   }
 
-  reference operator*() const { return (*(packed->data() + index)).second; }
-  pointer operator->() const { return &(*(packed->data() + index)).second; }
+  reference operator*() const { return (*values)[index]; }
+  pointer operator->() const { return &(*values)[index]; }
 
  protected:
   size_type index;
-  vector<internal_value_type>* packed;
+  Values* values;
 };
 
-template <typename I, typename T>
+template <typename I, typename T, typename Values = std::pmr::vector<T>>
 class const_packed_iterator {
  public:
-  using value_type = pair<I, T>;
-  using const_value_type = const pair<I, T>;
-  using size_type = typename std::vector<value_type>::size_type;
-  using pointer = value_type*;
-  using const_pointer = const_value_type*;
-  using reference = value_type&;
-  using const_reference = const_value_type&;
+  using value_type = pair<const I&, const T&>;
+  using const_value_type = const value_type;
+  using size_type = typename std::vector<T>::size_type;
+  using reference = value_type;
+  using const_reference = value_type;
   using difference_type = size_t;
   using iterator_category = std::bidirectional_iterator_tag;
 
+  struct pointer {
+    const value_type* operator->() const { return &value; }
+    value_type value;
+  };
+  using const_pointer = pointer;
+
   const_packed_iterator()
-      : index(static_cast<size_type>(-1)), packed(nullptr) {}
+      : index(static_cast<size_type>(-1)), packed(nullptr), values(nullptr) {}
 
-  const_packed_iterator(const vector<value_type>* packed, size_type index = 0)
-      : index(index), packed(packed) {}
+  const_packed_iterator(const std::pmr::vector<I>* packed,
+                        const Values* values, size_type index = 0)
+      : index(index), packed(packed), values(values) {}
 
   const_packed_iterator(const const_packed_iterator& other)
-      : index(other.index), packed(other.packed) {}
+      : index(other.index), packed(other.packed), values(other.values) {}
 
   const_packed_iterator& operator=(const_packed_iterator other) {
     swap(index, other.index);
     swap(packed, other.packed);
+    swap(values, other.values);
     return *this;
   }
 
@@ -136,31 +141,34 @@ class const_packed_iterator {
     return !(*this == other);
   }
 
-  const_reference operator*() const { return *(packed->data() + index); }
-  const_pointer operator->() const { return packed->data() + index; }
+  const_reference operator*() const {
+    return value_type(*(packed->data() + index), (*values)[index]);
+  }
+
+  const_pointer operator->() const { return pointer{**this}; }
 
  protected:
   size_type index;
-  const vector<value_type>* packed;
+  const std::pmr::vector<I>* packed;
+  const Values* values;
 };
 
 template <typename I, typename T>
 class const_sparse_iterator {
  public:
   using value_type = I;
-  using internal_value_type = pair<I, T>;
   using const_value_type = const I;
-  using size_type = typename std::vector<internal_value_type>::size_type;
+  using size_type = typename std::vector<value_type>::size_type;
   using pointer = value_type*;
   using const_pointer = const_value_type*;
   using reference = value_type&;
   using const_reference = const_value_type&;
-  using difference_type = typename std::vector<internal_value_type>::size_type;
+  using difference_type = typename std::vector<value_type>::size_type;
   using iterator_category = std::bidirectional_iterator_tag;
 
   const_sparse_iterator() : index(-1), packed(nullptr) {}
 
-  const_sparse_iterator(const vector<internal_value_type>* packed,
+  const_sparse_iterator(const std::pmr::vector<value_type>* packed,
                         size_type index = 0)
       : index(index), packed(packed) {}
 
@@ -203,19 +211,15 @@ class const_sparse_iterator {
     return !(*this == other);
   }
 
-  const_reference operator*() const {
-    return (*(packed->data() + index)).first;
-  }
+  const_reference operator*() const { return *(packed->data() + index); }
 
-  const_pointer operator->() const {
-    return &(*(packed->data() + index)).first;
-  }
+  const_pointer operator->() const { return packed->data() + index; }
 
  protected:
   size_type index;
-  const vector<internal_value_type>* packed;
+  const std::pmr::vector<value_type>* packed;
 };
 
 }  // namespace yacs
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,92 @@
+#ifndef YACS_RADIX_SORT_H
+#define YACS_RADIX_SORT_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+using std::vector;
+
+namespace yacs {
+
+// Below this many elements a comparison sort beats the histogram setup.
+constexpr size_t RADIX_SORT_THRESHOLD = 256;
+
+// Maps an arithmetic key to an unsigned integer with the same ordering.
+template <typename Key>
+auto radix_key(Key key) {
+  static_assert(std::is_arithmetic_v<Key>, "radix keys must be arithmetic");
+  if constexpr (std::is_same_v<Key, bool>) {
+    return static_cast<std::uint8_t>(key);
+  } else if constexpr (std::is_floating_point_v<Key>) {
+    static_assert(sizeof(Key) == 4 || sizeof(Key) == 8,
+                  "unsupported floating point key");
+    using bits_type =
+        std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t>;
+    constexpr bits_type sign = bits_type(1) << (sizeof(Key) * 8 - 1);
+    bits_type bits;
+    std::memcpy(&bits, &key, sizeof(Key));
+    return static_cast<bits_type>(bits & sign ? ~bits : bits | sign);
+  } else if constexpr (std::is_signed_v<Key>) {
+    using bits_type = std::make_unsigned_t<Key>;
+    constexpr bits_type sign = bits_type(1) << (sizeof(Key) * 8 - 1);
+    return static_cast<bits_type>(static_cast<bits_type>(key) ^ sign);
+  } else {
+    return key;
+  }
+}
+
+// Stable LSD radix sort of order by the unsigned keys, one byte per pass.
+// All histograms are built in a single read and passes where every key has
+// the same byte are skipped, so small sparse indices only pay for the low
+// bytes. On return keys is clobbered.
+template <typename Key, typename Index>
+void radix_sort(vector<Key>& keys, vector<Index>& order) {
+  static_assert(std::is_unsigned_v<Key>, "radix_sort expects radix_key()");
+  auto n = keys.size();
+  if (n < RADIX_SORT_THRESHOLD) {
+    std::stable_sort(order.begin(), order.end(),
+                     [&keys](Index lhs, Index rhs) {
+                       return keys[lhs] < keys[rhs];
+                     });
+    return;
+  }
+
+  constexpr size_t PASSES = sizeof(Key);
+  std::array<std::array<size_t, 256>, PASSES> counts{};
+  for (auto key : keys) {
+    for (size_t pass = 0; pass < PASSES; ++pass) {
+      ++counts[pass][(key >> (pass * 8)) & 0xff];
+    }
+  }
+
+  vector<Key> key_buffer(n);
+  vector<Index> order_buffer(n);
+  for (size_t pass = 0; pass < PASSES; ++pass) {
+    auto& offsets = counts[pass];
+    auto shift = pass * 8;
+    if (offsets[(keys[0] >> shift) & 0xff] == n) {
+      continue;
+    }
+    size_t offset = 0;
+    for (auto& count : offsets) {
+      auto bucket = count;
+      count = offset;
+      offset += bucket;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      auto position = offsets[(keys[i] >> shift) & 0xff]++;
+      key_buffer[position] = keys[i];
+      order_buffer[position] = order[i];
+    }
+    keys.swap(key_buffer);
+    order.swap(order_buffer);
+  }
+}
+
+}  // namespace yacs
+
+#endif
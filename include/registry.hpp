@@ -1,19 +1,27 @@
 #ifndef YACS_REGISTRY_H
 #define YACS_REGISTRY_H
 
-#include <bitset>
+#include <atomic>
 #include <cstdint>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "group.hpp"
 #include "pool.hpp"
 #include "types.hpp"
+#include "view.hpp"
 
+using std::pair;
 using std::unique_ptr;
 using std::vector;
 
 namespace yacs {
 
+class concurrent_registry;
 class entity;
 
 class registry {
@@ -21,66 +29,266 @@ class registry {
   template <typename T>
   using storage_type = yacs::packed_pool<T>;
 
-  registry() {}
+  registry() : registry(std::pmr::get_default_resource()) {}
+  // The entity table, the pools and groups themselves, and the tables that
+  // index them all allocate from resource, which must outlive the registry.
+  explicit registry(std::pmr::memory_resource* resource)
+      : m_free_head(NO_FREE_SLOT),
+        m_pools(resource),
+        m_groups(resource),
+        m_owners(resource),
+        m_entities(resource),
+        m_resource(resource),
+        m_tick(1),
+        m_parallel_systems(0) {}
   ~registry() {
-    for (auto p : m_pools) {
-      delete p;
+    for (auto* p : m_pools) {
+      if (p) {
+        p->dispose(m_resource);
+      }
+    }
+    for (auto* handler : m_groups) {
+      handler->dispose(m_resource);
     }
   }
 
-  registry(registry&& other) {
-    swap(m_entities, other.m_entities);
-    swap(m_free, other.m_free);
-    swap(m_pools, other.m_pools);
-  }
+  registry(registry&& other) : registry(other.m_resource) { swap(other); }
 
+  // pmr containers keep their resource on assignment, so registries on
+  // different resources are rebuilt in place to trade resources as well.
   registry& operator=(registry&& other) {
-    swap(m_entities, other.m_entities);
-    swap(m_free, other.m_free);
-    swap(m_pools, other.m_pools);
+    if (m_resource == other.m_resource) {
+      swap(other);
+    } else {
+      registry moved(std::move(other));
+      other.rebuild(std::move(*this));
+      rebuild(std::move(moved));
+    }
     return *this;
   }
 
   entity create();
   entity get(entity_id id);
+  bool valid(entity_id id) const;
+  entity_id id(entity_index index) const;
+
+  template <typename OutputIt>
+  void create(size_t n, OutputIt out) {
+    for (; n > 0 && free_head() != NO_FREE_SLOT; --n) {
+      auto& slot = pop_free();
+      *out++ = get_entity_id(slot.index, slot.version);
+    }
+    if (n == 0) {
+      return;
+    }
+    auto index = static_cast<entity_index>(m_entities.size());
+    m_entities.grow(n);
+    m_entities.reserve_sparse(index + n - 1);
+    for (auto last = index + n; index < last; ++index) {
+      m_entities.construct(index, entity_slot{index, 0, component_mask()});
+      *out++ = get_entity_id(index, 0);
+    }
+  }
 
   void destroy(entity_id id);
   void destroy(entity entity);
 
+  // The slot masks sort the range into one batch per pool, so each pool
+  // and its owning group is called once rather than once per entity. Stale
+  // ids are skipped, and so are repeats, since the first pass already bumps
+  // each version.
+  template <typename It>
+  void destroy(It first, It last) {
+    vector<vector<pool::index_type>> batches(m_pools.size());
+    vector<entity_index> destroyed;
+    for (; first != last; ++first) {
+      if (!valid(*first)) {
+        continue;
+      }
+      auto index = get_entity_index(*first);
+      auto& slot = m_entities[index];
+      slot.mask.each(
+          [&batches, index](size_t i) { batches[i].push_back(index); });
+      ++slot.version;
+      destroyed.push_back(index);
+    }
+    for (size_t i = 0; i < batches.size(); ++i) {
+      auto& batch = batches[i];
+      if (batch.empty()) {
+        continue;
+      }
+      if (m_owners[i]) {
+        m_owners[i]->on_destroy(batch.data(), batch.size());
+      }
+      m_pools[i]->destroy(batch.data(), batch.size());
+    }
+    for (auto index : destroyed) {
+      auto& slot = m_entities[index];
+      slot.mask.reset();
+      push_free(slot, index);
+    }
+  }
+
+  // Moves the entities in [first, last) with all their components into
+  // other, one pool at a time, and destroys them here. The result pairs
+  // each id with its new id in other, in input order.
+  template <typename It>
+  vector<pair<entity_id, entity_id>> move_to(registry& other, It first,
+                                             It last) {
+    vector<pair<entity_id, entity_id>> translation;
+    translation.reserve(static_cast<size_t>(std::distance(first, last)));
+    for (; first != last; ++first) {
+      translation.emplace_back(*first, entity_id());
+    }
+    transfer(other, translation);
+    return translation;
+  }
+
+  // Moves every entity of other into this registry.
+  vector<pair<entity_id, entity_id>> merge(registry& other);
+
   template <typename T>
   void destroy(entity_id id) {
     auto component_index = component_traits<T>::id();
-    if (component_index >= m_pools.size()) {
+    if (component_index >= m_pools.size() || !m_pools[component_index]) {
       return;
     }
     storage_type<T>* pool =
         static_cast<storage_type<T>*>(m_pools[component_index]);
-    pool->destroy(get_entity_index(id));
+    auto index = get_entity_index(id);
+    if (m_owners[component_index]) {
+      m_owners[component_index]->on_destroy(index);
+    }
+    pool->destroy(index);
+    m_entities[index].mask.reset(component_index);
   }
 
   template <typename T, typename... Args>
   T& add(entity_id id, Args&&... args) {
+    auto* pool = assure<T>();
+    auto index = get_entity_index(id);
+    auto& component = pool->construct(index, forward<Args>(args)...);
+    m_entities[index].mask.set(component_traits<T>::id());
+    auto* owner = m_owners[component_traits<T>::id()];
+    if (owner) {
+      owner->on_construct(index);
+      return pool->access(index);
+    }
+    return component;
+  }
+
+  template <typename T, typename It, typename Source,
+            typename = std::enable_if_t<!std::is_integral_v<It>>>
+  void add(It first, It last, const Source& source) {
+    auto* pool = assure<T>();
+    pool->grow(static_cast<size_t>(std::distance(first, last)));
     auto component_index = component_traits<T>::id();
-    if (component_index >= m_pools.size()) {
-      m_pools.emplace_back(new packed_pool<T>());
+    auto* owner = m_owners[component_index];
+    for (; first != last; ++first) {
+      auto index = get_entity_index(*first);
+      m_entities[index].mask.set(component_index);
+      if constexpr (std::is_invocable_r_v<T, const Source&, entity_id>) {
+        pool->construct(index, source(*first));
+      } else {
+        pool->construct(index, source);
+      }
+      if (owner) {
+        owner->on_construct(index);
+      }
     }
-    storage_type<T>* pool =
-        static_cast<storage_type<T>*>(m_pools[component_index]);
-    return pool->construct(get_entity_index(id), forward<Args>(args)...);
+  }
+
+  template <typename T, typename Fn>
+  T& patch(entity_id id, Fn fn) {
+    return assure<T>()->patch(get_entity_index(id), fn);
+  }
+
+  template <typename T, typename... Args>
+  T& replace(entity_id id, Args&&... args) {
+    return assure<T>()->replace(get_entity_index(id), forward<Args>(args)...);
+  }
+
+  template <typename T>
+  signal<pool::index_type>& on_construct() {
+    return assure<T>()->on_construct();
+  }
+
+  template <typename T>
+  signal<pool::index_type>& on_update() {
+    return assure<T>()->on_update();
+  }
+
+  template <typename T>
+  signal<pool::index_type>& on_destroy() {
+    return assure<T>()->on_destroy();
+  }
+
+  template <typename T>
+  bool has(entity_id id) {
+    auto component_index = component_traits<T>::id();
+    return component_index < m_pools.size() && m_pools[component_index] &&
+           m_pools[component_index]->contains(get_entity_index(id));
   }
 
   template <typename T>
   T& get(entity_id id) {
     auto component_index = component_traits<T>::id();
-    assert(component_index < m_pools.size());
+    assert(component_index < m_pools.size() && m_pools[component_index]);
     storage_type<T>* pool =
         static_cast<storage_type<T>*>(m_pools[component_index]);
     return pool->access(get_entity_index(id));
   }
 
-  void view() {}
+  // Systems remember tick() when they run and pass it to view::changed or
+  // view::added on their next run; advance() moves every pool to a new tick.
+  // The scheduler does this per system run, so writes earlier in a frame
+  // are fresh to the systems after them.
+  pool::tick_type tick() const {
+    return m_tick.load(std::memory_order_relaxed);
+  }
+  std::pmr::memory_resource* resource() const { return m_resource; }
+  pool::tick_type advance();
+
+  vector<entity_id> query(const component_mask& include,
+                          const component_mask& exclude = {}) const;
+
+  template <typename... Ts>
+  static component_mask mask() {
+    component_mask mask;
+    (mask.set(component_traits<Ts>::id()), ...);
+    return mask;
+  }
+
+  template <typename T>
+  storage_type<T>& storage() {
+    return *assure<T>();
+  }
+
+  template <typename... Ts>
+  yacs::view<Ts...> view() {
+    return yacs::view<Ts...>(*assure<std::remove_const_t<Ts>>()...);
+  }
+
+  template <typename... Ts>
+  yacs::group<Ts...> group() {
+    (assure<Ts>(), ...);
+    group_handler* owners[] = {m_owners[component_traits<Ts>::id()]...};
+    group_handler* handler = owners[0];
+    if (!handler) {
+      handler = new_object<owning_group_handler<Ts...>>(m_resource,
+                                                        *assure<Ts>()...);
+      m_groups.push_back(handler);
+    }
+    for (auto* owner : owners) {
+      assert((!owner || owner == handler) && "component owned by a group");
+    }
+    assert(handler->owned() == sizeof...(Ts));
+    ((m_owners[component_traits<Ts>::id()] = handler), ...);
+    return yacs::group<Ts...>(handler->size(), *assure<Ts>()...);
+  }
 
-  void sort(function<bool(const entity_slot&, const entity_slot&)> comparator) {
+  template <typename Compare>
+  void sort(Compare comparator) {
     m_entities.sort(comparator);
   }
 
@@ -89,17 +297,106 @@ class registry {
       if (lhs.mask == rhs.mask) {
         return lhs.index < rhs.index;
       }
-      return lhs.mask.to_ullong() < rhs.mask.to_ullong();
+      return lhs.mask < rhs.mask;
     });
   }
 
  protected:
+  friend class concurrent_registry;
+  friend class delta;
+  friend class scheduler;
+  friend class snapshot;
+
+  static constexpr entity_index NO_FREE_SLOT = static_cast<entity_index>(-1);
+
+  // Destroyed slots form a LIFO list threaded through their index field,
+  // starting at m_free_head; pop_free() restores the index on reuse. The
+  // head is atomic only so concurrent_registry can pop from it; the serial
+  // paths use relaxed accesses.
+  entity_index free_head() const {
+    return m_free_head.load(std::memory_order_relaxed);
+  }
+
+  void set_free_head(entity_index index) {
+    m_free_head.store(index, std::memory_order_relaxed);
+  }
+
+  void push_free(entity_slot& slot, entity_index index) {
+    slot.index = free_head();
+    set_free_head(index);
+  }
+
+  entity_slot& pop_free() {
+    auto index = free_head();
+    auto& slot = m_entities[index];
+    set_free_head(slot.index);
+    slot.index = index;
+    return slot;
+  }
+
+  template <typename Fn>
+  void each_free(Fn fn) const {
+    for (auto index = free_head(); index != NO_FREE_SLOT;
+         index = m_entities[index].index) {
+      fn(index);
+    }
+  }
+
+  // Swaps the contents of two registries on the same resource.
+  void swap(registry& other) {
+    using std::swap;
+    swap(m_entities, other.m_entities);
+    set_free_head(other.m_free_head.exchange(free_head()));
+    swap(m_pools, other.m_pools);
+    swap(m_groups, other.m_groups);
+    swap(m_owners, other.m_owners);
+    m_tick.store(other.m_tick.exchange(tick()));
+  }
+
+  void rebuild(registry&& other) {
+    this->~registry();
+    new (this) registry(std::move(other));
+  }
+
+  void transfer(registry& other,
+                vector<pair<entity_id, entity_id>>& translation);
+  pool* assure(component_id component_index, const pool& prototype);
+
+  template <typename T>
+  storage_type<T>* assure() {
+    auto component_index = component_traits<T>::id();
+    assert((m_parallel_systems.load(std::memory_order_relaxed) == 0 ||
+            (component_index < m_pools.size() && m_pools[component_index])) &&
+           "component registered while parallel systems run");
+    if (component_index >= m_pools.size()) {
+      m_pools.resize(component_index + 1, nullptr);
+    }
+    if (component_index >= m_owners.size()) {
+      m_owners.resize(component_index + 1, nullptr);
+    }
+    if (!m_pools[component_index]) {
+      m_pools[component_index] =
+          new_object<storage_type<T>>(m_resource, m_resource);
+      m_pools[component_index]->set_tick(tick());
+    }
+    return static_cast<storage_type<T>*>(m_pools[component_index]);
+  }
+
   registry(const registry& other) = delete;
   registry& operator=(const registry& other) = delete;
 
-  vector<entity_slot*> m_free;
-  vector<pool*> m_pools;
+  std::atomic<entity_index> m_free_head;
+  std::pmr::vector<pool*> m_pools;
+  std::pmr::vector<group_handler*> m_groups;
+  std::pmr::vector<group_handler*> m_owners;
   packed_pool<entity_slot> m_entities;
+  std::pmr::memory_resource* m_resource;
+  // Atomic so systems running at once can each draw a tick of their own.
+  std::atomic<pool::tick_type> m_tick;
+  // Non-exclusive systems the scheduler is running. Registering a pool
+  // meanwhile could grow m_pools under them, so scheduler::add registers
+  // the components a system declares up front.
+  std::atomic<size_t> m_parallel_systems;
 };
 
 }  // namespace yacs
@@ -0,0 +1,96 @@
+#ifndef YACS_SCHEDULER_H
+#define YACS_SCHEDULER_H
+
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "registry.hpp"
+#include "thread_pool.hpp"
+#include "types.hpp"
+
+using std::function;
+using std::string;
+using std::vector;
+
+namespace yacs {
+
+template <typename... Ts>
+struct reads {};
+
+template <typename... Ts>
+struct writes {};
+
+// Each run of a system draws a new registry tick and stamps it into the
+// pools the system writes, which no system running at the same time can
+// touch. A system that takes (registry&, tick_type) is passed the tick of its
+// own previous run, so view::changed and view::added see every write made
+// since then, including those earlier in the same frame.
+class scheduler {
+ public:
+  using tick_type = pool::tick_type;
+  using system_type = function<void(registry&, tick_type)>;
+
+  explicit scheduler(registry& registry,
+                     thread_pool& executor = thread_pool::shared())
+      : m_registry(registry), m_executor(executor) {}
+
+  template <typename... Rs, typename... Ws, typename Fn>
+  scheduler& add(string name, reads<Rs...>, writes<Ws...>, Fn fn) {
+    (m_registry.storage<Rs>(), ...);
+    (m_registry.storage<Ws>(), ...);
+    m_systems.push_back({std::move(name),
+                         wrap(std::move(fn)),
+                         {component_traits<Rs>::id()...},
+                         {component_traits<Ws>::id()...},
+                         false});
+    return *this;
+  }
+
+  template <typename Fn>
+  scheduler& add_exclusive(string name, Fn fn) {
+    m_systems.push_back({std::move(name), wrap(std::move(fn)), {}, {}, true});
+    return *this;
+  }
+
+  void run();
+
+  size_t size() const { return m_systems.size(); }
+  const vector<vector<size_t>>& dependencies() const { return m_successors; }
+
+ protected:
+  struct system {
+    string name;
+    system_type fn;
+    vector<component_id> reads;
+    vector<component_id> writes;
+    bool exclusive;
+    tick_type last_run = 0;
+  };
+
+  template <typename Fn>
+  static system_type wrap(Fn fn) {
+    if constexpr (std::is_invocable_v<Fn&, registry&, tick_type>) {
+      return system_type(std::move(fn));
+    } else {
+      return [fn = std::move(fn)](registry& registry, tick_type) mutable {
+        fn(registry);
+      };
+    }
+  }
+
+  static bool conflicts(const system& lhs, const system& rhs);
+  void build();
+  void run_system(system& system);
+
+  registry& m_registry;
+  thread_pool& m_executor;
+  vector<system> m_systems;
+  vector<vector<size_t>> m_successors;
+  vector<size_t> m_predecessors;
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef YACS_SIGNAL_H
+#define YACS_SIGNAL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+using std::function;
+using std::vector;
+
+namespace yacs {
+
+// Listeners are called in connection order. They must not connect or
+// disconnect on the signal that is currently publishing.
+template <typename... Args>
+class signal {
+ public:
+  using connection = size_t;
+
+  explicit signal(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : m_listeners(resource), m_next(0) {}
+
+  template <typename Fn>
+  connection connect(Fn fn) {
+    m_listeners.emplace_back(++m_next, function<void(Args...)>(std::move(fn)));
+    return m_next;
+  }
+
+  void disconnect(connection id) {
+    m_listeners.erase(
+        std::remove_if(m_listeners.begin(), m_listeners.end(),
+                       [id](const auto& listener) {
+                         return listener.first == id;
+                       }),
+        m_listeners.end());
+  }
+
+  void publish(Args... args) const {
+    for (auto& listener : m_listeners) {
+      listener.second(args...);
+    }
+  }
+
+  bool empty() const { return m_listeners.empty(); }
+  size_t size() const { return m_listeners.size(); }
+
+ protected:
+  std::pmr::vector<std::pair<connection, function<void(Args...)>>>
+      m_listeners;
+  connection m_next;
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef YACS_SNAPSHOT_H
+#define YACS_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+#include "pool.hpp"
+#include "registry.hpp"
+#include "types.hpp"
+
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace yacs {
+
+// Snapshot file layout, in native byte order:
+//
+//   snapshot_header
+//   snapshot_section[header.sections]   entity table first, then components
+//   aligned blocks                      packed indices, values, free list
+//
+// Every block starts on a SNAPSHOT_ALIGNMENT boundary, so a mapped file can
+// be read in place. Trivially copyable values are stored raw, anything else
+// goes through serializer<T>.
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr size_t SNAPSHOT_ALIGNMENT = 64;
+
+struct snapshot_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t sections;
+  uint32_t index_size;
+  uint32_t reserved;
+  uint64_t free_count;
+  uint64_t free_offset;
+};
+
+struct snapshot_section {
+  static constexpr uint32_t RAW = 0;
+  static constexpr uint32_t SERIALIZED = 1;
+
+  uint64_t hash;
+  uint32_t size;
+  uint32_t flags;
+  uint64_t count;
+  uint64_t indices;
+  uint64_t values;
+  uint64_t bytes;
+};
+
+class snapshot_writer {
+ public:
+  explicit snapshot_writer(const char* path);
+
+  bool good() const { return m_file.good(); }
+  uint64_t tell() { return static_cast<uint64_t>(m_file.tellp()); }
+  void seek(uint64_t offset);
+  uint64_t align();
+  void write(const void* data, size_t bytes);
+
+  template <typename U>
+  void write(const U& value) {
+    static_assert(std::is_trivially_copyable_v<U>,
+                  "write members of non-trivial types one by one");
+    write(&value, sizeof(U));
+  }
+
+ protected:
+  std::ofstream m_file;
+};
+
+class snapshot_reader {
+ public:
+  explicit snapshot_reader(const char* path);
+  ~snapshot_reader();
+
+  bool good() const { return m_data != nullptr; }
+  const char* data() const { return m_data; }
+  size_t size() const { return m_size; }
+
+  bool contains(uint64_t offset, uint64_t bytes) const {
+    return offset <= m_size && bytes <= m_size - offset;
+  }
+
+  // count elements of size bytes at offset, aligned to alignment. Counts
+  // come from the file, so the product is never formed before the bound
+  // check.
+  bool contains(uint64_t offset, uint64_t count, uint64_t size,
+                size_t alignment) const {
+    return offset % alignment == 0 && offset <= m_size &&
+           (size == 0 || count <= (m_size - offset) / size);
+  }
+
+  void seek(uint64_t offset) { m_cursor = offset; }
+  bool read(void* out, size_t bytes);
+
+  template <typename U>
+  U read() {
+    static_assert(std::is_trivially_copyable_v<U>,
+                  "read members of non-trivial types one by one");
+    U value;
+    read(&value, sizeof(U));
+    return value;
+  }
+
+ protected:
+  snapshot_reader(const snapshot_reader& other) = delete;
+  snapshot_reader& operator=(const snapshot_reader& other) = delete;
+
+  const char* m_data;
+  size_t m_size;
+  size_t m_cursor;
+  bool m_mapped;
+  vector<char> m_buffer;
+};
+
+// Specialize for components that are not trivially copyable:
+//
+//   template <> struct serializer<name> {
+//     static void write(snapshot_writer& out, const name& value);
+//     static name read(snapshot_reader& in);
+//   };
+template <typename T>
+struct serializer;
+
+// Saves and restores a registry. Only the listed component types are written
+// or read; components are matched by component_traits<T>::hash, so ids may
+// differ between the process that saved and the one that loads. Loading
+// replaces the registry, including pools for types not in the list.
+class snapshot {
+ public:
+  template <typename... Ts>
+  static bool save(const registry& registry, const char* path) {
+    snapshot_writer out(path);
+    vector<snapshot_section> sections(1 + sizeof...(Ts));
+    out.write(snapshot_header{});
+    out.write(sections.data(), sections.size() * sizeof(snapshot_section));
+
+    auto header = write_entities(out, registry, sections);
+    [[maybe_unused]] size_t next = 1;
+    (write_pool<Ts>(out, registry, sections[next++]), ...);
+
+    out.seek(0);
+    out.write(header);
+    out.write(sections.data(), sections.size() * sizeof(snapshot_section));
+    return out.good();
+  }
+
+  // The file is loaded into a new registry, which replaces the given one
+  // only once every section has been read; a failed load leaves it as it
+  // was.
+  template <typename... Ts>
+  static bool load(registry& registry, const char* path) {
+    snapshot_reader in(path);
+    vector<snapshot_section> sections;
+    yacs::registry loaded(registry.resource());
+    if (!read_entities(in, loaded, sections) ||
+        !(read_pool<Ts>(in, loaded, sections) && ...)) {
+      return false;
+    }
+    registry = std::move(loaded);
+    return true;
+  }
+
+ protected:
+  template <typename T>
+  static void write_pool(snapshot_writer& out, const registry& registry,
+                         snapshot_section& section) {
+    auto component_index = component_traits<T>::id();
+    const packed_pool<T>* storage =
+        component_index < registry.m_pools.size()
+            ? static_cast<const packed_pool<T>*>(
+                  registry.m_pools[component_index])
+            : nullptr;
+    section.hash = component_traits<T>::hash;
+    section.size = value_size<T>();
+    section.count = storage ? storage->size() : 0;
+    section.indices = out.align();
+    if (storage) {
+      out.write(storage->data(), storage->size() * sizeof(pool::index_type));
+    }
+    section.values = out.align();
+    if constexpr (is_tag_v<T>) {
+      section.flags = snapshot_section::RAW;
+    } else if constexpr (std::is_trivially_copyable_v<T>) {
+      section.flags = snapshot_section::RAW;
+      if (storage) {
+        out.write(storage->raw(), storage->size() * sizeof(T));
+      }
+    } else {
+      section.flags = snapshot_section::SERIALIZED;
+      for (size_t i = 0; i < section.count; ++i) {
+        serializer<T>::write(out, storage->raw()[i]);
+      }
+    }
+    section.bytes = out.tell() - section.values;
+  }
+
+  template <typename T>
+  static bool read_pool(snapshot_reader& in, registry& registry,
+                        const vector<snapshot_section>& sections) {
+    auto* section = find(sections, component_traits<T>::hash);
+    if (!section) {
+      return true;
+    }
+    constexpr auto flags = is_tag_v<T> || std::is_trivially_copyable_v<T>
+                               ? snapshot_section::RAW
+                               : snapshot_section::SERIALIZED;
+    if (section->size != value_size<T>() || section->flags != flags ||
+        (flags == snapshot_section::RAW &&
+         section->values % alignof(T) != 0)) {
+      return false;
+    }
+
+    auto* indices =
+        reinterpret_cast<const pool::index_type*>(in.data() + section->indices);
+    if (!claim(registry, indices, section->count, component_traits<T>::id())) {
+      return false;
+    }
+    auto* storage = registry.assure<T>();
+    if constexpr (is_tag_v<T> || std::is_trivially_copyable_v<T>) {
+      storage->assign(indices,
+                      reinterpret_cast<const T*>(in.data() + section->values),
+                      section->count);
+    } else {
+      storage->destroy();
+      storage->grow(section->count);
+      in.seek(section->values);
+      for (size_t i = 0; i < section->count; ++i) {
+        storage->construct(indices[i], serializer<T>::read(in));
+      }
+    }
+    return true;
+  }
+
+  // Tag sections carry indices only.
+  template <typename T>
+  static constexpr uint64_t value_size() {
+    return is_tag_v<T> ? 0 : sizeof(T);
+  }
+
+  static snapshot_header write_entities(snapshot_writer& out,
+                                        const registry& registry,
+                                        vector<snapshot_section>& sections);
+  static bool read_entities(snapshot_reader& in, registry& registry,
+                            vector<snapshot_section>& sections);
+  static const snapshot_section* find(const vector<snapshot_section>& sections,
+                                      uint64_t hash);
+  // Sets bit id in the mask of every listed entity. Fails, before the pool
+  // is touched, if an index is not a live entity or is listed twice.
+  static bool claim(registry& registry, const pool::index_type* indices,
+                    size_t count, component_id id);
+};
+
+}  // namespace yacs
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef YACS_THREAD_POOL_H
+#define YACS_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::function;
+using std::vector;
+
+namespace yacs {
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Any executor passed to parallel_each must provide concurrency() and
+// parallel_for(count, grain, fn), calling fn(begin, end) for every chunk.
+// Each worker owns a deque: it pops its own tasks LIFO and steals from the
+// front of the others when it runs dry. Idle workers and waiting callers
+// retry SPIN_LIMIT times before they sleep on the condition variable.
+class thread_pool {
+ public:
+  static constexpr size_t SPIN_LIMIT = 64;
+
+  explicit thread_pool(size_t workers = default_workers());
+  ~thread_pool();
+
+  thread_pool(const thread_pool& other) = delete;
+  thread_pool& operator=(const thread_pool& other) = delete;
+
+  size_t concurrency() const { return m_workers.size() + 1; }
+
+  template <typename Fn>
+  void parallel_for(size_t count, size_t grain, Fn&& fn);
+
+  void submit(function<void()> task);
+  bool run_pending();
+  // Runs pending tasks until remaining drops to zero. Tasks count it down
+  // with finish(), which wakes a waiter that went to sleep.
+  void wait(const std::atomic<size_t>& remaining);
+  void finish(std::atomic<size_t>& remaining);
+
+  static thread_pool& shared();
+  static size_t default_workers();
+
+ protected:
+  struct task_queue {
+    std::mutex mutex;
+    std::deque<function<void()>> tasks;
+  };
+
+  void work(size_t index);
+  bool pop(size_t index, function<void()>& task);
+  bool steal(size_t index, function<void()>& task);
+  size_t current_queue() const;
+
+  vector<std::thread> m_workers;
+  vector<std::unique_ptr<task_queue>> m_queues;
+  std::atomic<size_t> m_pending;
+  std::atomic<size_t> m_next_queue;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  bool m_stop;
+};
+
+template <typename T>
+size_t chunk_size(size_t count, size_t concurrency) {
+  constexpr size_t per_line = std::max<size_t>(1, CACHE_LINE_SIZE / sizeof(T));
+  size_t chunk = std::max<size_t>(count / (concurrency * 8), per_line * 16);
+  return (chunk + per_line - 1) / per_line * per_line;
+}
+
+template <typename Fn>
+void thread_pool::parallel_for(size_t count, size_t grain, Fn&& fn) {
+  grain = std::max<size_t>(grain, 1);
+  size_t chunks = (count + grain - 1) / grain;
+  if (chunks <= 1 || m_workers.empty()) {
+    if (count > 0) {
+      fn(size_t(0), count);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  auto run = [&]() {
+    for (size_t chunk = next.fetch_add(1); chunk < chunks;
+         chunk = next.fetch_add(1)) {
+      size_t begin = chunk * grain;
+      fn(begin, std::min(count, begin + grain));
+    }
+  };
+
+  size_t helpers = std::min(chunks - 1, m_workers.size());
+  std::atomic<size_t> remaining(helpers);
+  for (size_t i = 0; i < helpers; ++i) {
+    submit([&]() {
+      run();
+      finish(remaining);
+    });
+  }
+  run();
+  wait(remaining);
+}
+
+}  // namespace yacs
+
+#endif
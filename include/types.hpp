@@ -1,18 +1,22 @@
 #ifndef YACS_TYPES_H
 #define YACS_TYPES_H
 
-#include <bitset>
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
+
+#include "component_mask.hpp"
+
+#ifndef YACS_STATIC_COMPONENTS
+#define YACS_STATIC_COMPONENTS 0
+#endif
 
-using std::bitset;
 using std::uint32_t;
 using std::uint64_t;
 
 namespace yacs {
 
 typedef uint64_t component_id;
-constexpr uint32_t MAX_COMPONENTS = sizeof(component_id);
-typedef bitset<MAX_COMPONENTS> component_mask;
 
 typedef uint64_t entity_id;
 typedef uint32_t entity_index;
@@ -28,16 +32,74 @@ entity_index get_entity_index(entity_id id);
 entity_version get_entity_version(entity_id id);
 entity_id get_entity_id(entity_index index, entity_version version);
 
+size_t match_slots(const entity_slot* slots, size_t count,
+                   const component_mask& include,
+                   const component_mask& exclude, entity_id* out);
+
+// Ids below STATIC_COMPONENTS are reserved for types declared with
+// YACS_COMPONENT; every other type draws the next id from the counter.
+constexpr component_id STATIC_COMPONENTS = YACS_STATIC_COMPONENTS;
+
+static_assert(STATIC_COMPONENTS <= MAX_COMPONENTS,
+              "YACS_STATIC_COMPONENTS exceeds YACS_MAX_COMPONENTS");
+
 extern component_id g_component_id_counter;
 
+// Draws the next dynamic id. Aborts once the ids outgrow the component mask,
+// since every mask operation on a wider id would be out of bounds.
+component_id next_component_id();
+
+constexpr uint64_t hash_name(std::string_view name) {
+  uint64_t hash = 14695981039346656037ull;
+  for (auto c : name) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+  }
+  return hash;
+}
+
+template <typename T>
+constexpr std::string_view type_name() {
+#if defined(_MSC_VER)
+  std::string_view name = __FUNCSIG__;
+  auto begin = name.find("type_name<") + 10;
+  auto end = name.rfind(">(void)");
+#else
+  std::string_view name = __PRETTY_FUNCTION__;
+  auto begin = name.find("T = ") + 4;
+  auto end = name.find_first_of(";]", begin);
+#endif
+  return name.substr(begin, end - begin);
+}
+
+// hash is derived from the type name, so it is the same in every process
+// built by the same compiler and can identify a component in saved data.
+// id is a dense index into the registry's pool table. It is assigned during
+// static initialization, so reading it costs a plain load without the guard
+// of a function-local static, but it must not be used from other static
+// initializers.
 template <typename T>
 struct component_traits {
-  static component_id id() {
-    static component_id id = g_component_id_counter++;
-    return id;
-  }
+  static constexpr uint64_t hash = hash_name(type_name<T>());
+
+  static component_id id() { return s_id; }
+
+ private:
+  inline static const component_id s_id = next_component_id();
 };
 
 }  // namespace yacs
 
+// Pins a component to a fixed id in [0, YACS_STATIC_COMPONENTS). Use it at
+// global scope, before the type is first used with a registry.
+#define YACS_COMPONENT(T, ID)                                            \
+  namespace yacs {                                                       \
+  template <>                                                            \
+  struct component_traits<T> {                                           \
+    static_assert((ID) < STATIC_COMPONENTS,                              \
+                  "raise YACS_STATIC_COMPONENTS to reserve this id");    \
+    static constexpr uint64_t hash = hash_name(type_name<T>());          \
+    static constexpr component_id id() { return (ID); }                  \
+  };                                                                     \
+  }
+
 #endif
\ No newline at end of file
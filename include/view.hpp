@@ -0,0 +1,308 @@
+#ifndef YACS_VIEW_H
+#define YACS_VIEW_H
+
+#include <array>
+#include <cassert>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pool.hpp"
+
+namespace yacs {
+
+template <typename... Ts>
+class view {
+  static_assert(sizeof...(Ts) > 0, "a view needs at least one component");
+
+ public:
+  using index_type = pool::index_type;
+  using tick_type = pool::tick_type;
+  using size_type = size_t;
+  using reference = std::tuple<Ts&...>;
+
+  template <typename T>
+  using storage_for = packed_pool<std::remove_const_t<T>>;
+
+  class iterator {
+   public:
+    using value_type = std::tuple<Ts&...>;
+    using reference = value_type;
+    using pointer = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    iterator() : m_view(nullptr), m_position(0) {}
+    iterator(const view* owner, size_type start)
+        : m_view(owner), m_position(start) {
+      skip();
+    }
+
+    iterator& operator++() {
+      ++m_position;
+      skip();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      auto copy = *this;
+      ++(*this);
+      return copy;
+    }
+
+    bool operator==(const iterator& other) const {
+      return m_view == other.m_view && m_position == other.m_position;
+    }
+
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    value_type operator*() const {
+      return m_view->get(m_view->driver_index(m_position));
+    }
+
+    index_type index() const { return m_view->driver_index(m_position); }
+
+   protected:
+    void skip() {
+      while (m_position < m_view->m_size &&
+             !m_view->contains(m_view->driver_index(m_position))) {
+        ++m_position;
+      }
+    }
+
+    const view* m_view;
+    size_type m_position;
+  };
+
+  explicit view(storage_for<Ts>&... pools)
+      : m_pools(&pools...),
+        m_added_since{},
+        m_changed_since{},
+        m_filtered(false) {
+    std::array<size_type, sizeof...(Ts)> sizes{pools.size()...};
+    m_driver = 0;
+    for (size_type i = 1; i < sizes.size(); ++i) {
+      if (sizes[i] < sizes[m_driver]) {
+        m_driver = i;
+      }
+    }
+    select_driver(std::index_sequence_for<Ts...>{});
+  }
+
+  // Narrow the view to elements of T added or changed after the given tick,
+  // usually the tick a system last ran at. T's pool must track ticks.
+  template <typename T>
+  view& added(tick_type since) {
+    constexpr auto I = position_of<T>(std::index_sequence_for<Ts...>{});
+    static_assert(I < sizeof...(Ts), "component is not part of this view");
+    assert(std::get<I>(m_pools)->tracks_ticks());
+    m_added_since[I] = since;
+    m_filtered = true;
+    return *this;
+  }
+
+  template <typename T>
+  view& changed(tick_type since) {
+    constexpr auto I = position_of<T>(std::index_sequence_for<Ts...>{});
+    static_assert(I < sizeof...(Ts), "component is not part of this view");
+    assert(std::get<I>(m_pools)->tracks_ticks());
+    m_changed_since[I] = since;
+    m_filtered = true;
+    return *this;
+  }
+
+  template <typename Fn>
+  void each(Fn fn) {
+    if (tracks_presence()) {
+      each_present(fn, std::index_sequence_for<Ts...>{});
+    } else {
+      dispatch(fn, std::index_sequence_for<Ts...>{});
+    }
+  }
+
+  template <typename Fn>
+  void parallel_each(Fn fn) {
+    parallel_each(fn, thread_pool::shared());
+  }
+
+  template <typename Fn, typename Executor>
+  void parallel_each(Fn fn, Executor& executor) {
+    parallel_dispatch(fn, executor, std::index_sequence_for<Ts...>{});
+  }
+
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, m_size); }
+
+  size_type size_hint() const { return m_size; }
+
+  bool contains(index_type index) const {
+    return std::apply(
+               [index](auto*... pools) {
+                 return (pools->contains(index) && ...);
+               },
+               m_pools) &&
+           fresh(index, std::index_sequence_for<Ts...>{});
+  }
+
+  reference get(index_type index) const {
+    return get(index, std::index_sequence_for<Ts...>{});
+  }
+
+  bool tracks_presence() const {
+    return std::apply(
+        [](auto*... pools) { return (pools->presence() && ...); }, m_pools);
+  }
+
+ protected:
+  template <size_t... Is>
+  void select_driver(std::index_sequence<Is...>) {
+    ((m_driver == Is ? (bind_driver(*std::get<Is>(m_pools)), true) : false) ||
+     ...);
+  }
+
+  template <typename T>
+  void bind_driver(packed_pool<T>& pool) {
+    m_size = pool.size();
+    m_indices = pool.data();
+  }
+
+  index_type driver_index(size_type position) const {
+    return m_indices[position];
+  }
+
+  template <typename T, size_t... Is>
+  static constexpr size_t position_of(std::index_sequence<Is...>) {
+    size_t position = sizeof...(Ts);
+    ((std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Ts>>
+          ? (position = Is)
+          : 0),
+     ...);
+    return position;
+  }
+
+  template <size_t... Is>
+  bool fresh(index_type index, std::index_sequence<Is...>) const {
+    return !m_filtered || (fresh_at<Is>(index) && ...);
+  }
+
+  template <size_t I>
+  bool fresh_at(index_type index) const {
+    auto* pool = std::get<I>(m_pools);
+    return (!m_added_since[I] || pool->added_tick(index) > m_added_since[I]) &&
+           (!m_changed_since[I] ||
+            pool->changed_tick(index) > m_changed_since[I]);
+  }
+
+  // Const components go through the const pool so reading them does not
+  // bump their changed tick.
+  template <size_t I>
+  std::tuple_element_t<I, std::tuple<Ts...>>& access(index_type index) const {
+    auto* pool = std::get<I>(m_pools);
+    if constexpr (std::is_const_v<std::tuple_element_t<I, std::tuple<Ts...>>>) {
+      return std::as_const(*pool).access(index);
+    } else {
+      return pool->access(index);
+    }
+  }
+
+  template <size_t... Is>
+  reference get(index_type index, std::index_sequence<Is...>) const {
+    return reference(access<Is>(index)...);
+  }
+
+  template <typename Fn, size_t... Is>
+  void dispatch(Fn& fn, std::index_sequence<Is...> sequence) {
+    ((m_driver == Is ? (each_from<Is>(fn, 0, m_size, sequence), true)
+                     : false) ||
+     ...);
+  }
+
+  template <typename Fn, size_t... Is>
+  void each_present(Fn& fn, std::index_sequence<Is...> sequence) {
+    std::array<const hierarchical_bitset*, sizeof...(Ts)> sets{
+        std::get<Is>(m_pools)->presence()...};
+    hierarchical_bitset::intersect(sets, [&](index_type index) {
+      if (!fresh(index, sequence)) {
+        return;
+      }
+      if constexpr (std::is_invocable_v<Fn&, index_type, Ts&...>) {
+        fn(index, access<Is>(index)...);
+      } else {
+        fn(access<Is>(index)...);
+      }
+    });
+  }
+
+  template <typename Fn, typename Executor, size_t... Is>
+  void parallel_dispatch(Fn& fn, Executor& executor,
+                         std::index_sequence<Is...> sequence) {
+    ((m_driver == Is ? (parallel_from<Is>(fn, executor, sequence), true)
+                     : false) ||
+     ...);
+  }
+
+  template <size_t D, typename Fn, typename Executor, size_t... Is>
+  void parallel_from(Fn& fn, Executor& executor,
+                     std::index_sequence<Is...> sequence) {
+    using driver_type = std::remove_const_t<
+        std::tuple_element_t<D, std::tuple<Ts...>>>;
+    auto grain = chunk_size<driver_type>(m_size, executor.concurrency());
+    executor.parallel_for(m_size, grain, [&](size_t begin, size_t end) {
+      each_from<D>(fn, begin, end, sequence);
+    });
+  }
+
+  template <size_t D, typename Fn, size_t... Is>
+  void each_from(Fn& fn, size_type begin, size_type end,
+                 std::index_sequence<Is...> sequence) {
+    auto* driver = std::get<D>(m_pools);
+    auto* indices = driver->data();
+    auto* values = driver->raw();
+    for (size_type i = begin; i < end; ++i) {
+      auto index = indices[i];
+      if (!(probe<Is, D>(index) && ...) || !fresh(index, sequence)) {
+        continue;
+      }
+      if constexpr (std::is_invocable_v<Fn&, index_type, Ts&...>) {
+        fn(index, fetch<Is, D>(index, column_at(values, i))...);
+      } else {
+        fn(fetch<Is, D>(index, column_at(values, i))...);
+      }
+    }
+  }
+
+  template <size_t I, size_t D>
+  bool probe(index_type index) const {
+    if constexpr (I == D) {
+      return true;
+    } else {
+      return std::get<I>(m_pools)->contains(index);
+    }
+  }
+
+  template <size_t I, size_t D, typename V>
+  std::tuple_element_t<I, std::tuple<Ts...>>& fetch(index_type index,
+                                                    V& driver_value) {
+    if constexpr (I != D) {
+      return access<I>(index);
+    } else {
+      if constexpr (!std::is_const_v<
+                        std::tuple_element_t<I, std::tuple<Ts...>>>) {
+        std::get<I>(m_pools)->touch(index);
+      }
+      return driver_value;
+    }
+  }
+
+  std::tuple<storage_for<Ts>*...> m_pools;
+  std::array<tick_type, sizeof...(Ts)> m_added_since;
+  std::array<tick_type, sizeof...(Ts)> m_changed_since;
+  bool m_filtered;
+  size_type m_driver;
+  size_type m_size;
+  const index_type* m_indices;
+};
+
+}  // namespace yacs
+
+#endif
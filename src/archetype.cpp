@@ -0,0 +1,90 @@
+#include "archetype.hpp"
+
+namespace {
+size_t align_up(size_t offset, size_t align) {
+  return (offset + align - 1) / align * align;
+}
+}  // namespace
+
+yacs::archetype::archetype(vector<component_id> types,
+                           const vector<column_info>& infos)
+    : m_types(std::move(types)), m_chunk_align(CACHE_LINE_SIZE), m_size(0) {
+  size_t stride = sizeof(entity_id);
+  for (size_t i = 0; i < m_types.size(); ++i) {
+    auto id = m_types[i];
+    if (id >= m_columns.size()) {
+      m_columns.resize(id + 1, NO_COLUMN);
+    }
+    m_columns[id] = i;
+    m_infos.push_back(infos[id]);
+    stride += infos[id].size;
+    m_chunk_align = std::max(m_chunk_align, infos[id].align);
+  }
+
+  auto layout = [this](size_t capacity) {
+    m_offsets.clear();
+    size_t offset = sizeof(entity_id) * capacity;
+    for (auto& info : m_infos) {
+      offset = align_up(offset, info.align);
+      m_offsets.push_back(offset);
+      offset += info.size * capacity;
+    }
+    return offset;
+  };
+
+  m_capacity = std::max<size_t>(CHUNK_SIZE / stride, 1);
+  m_chunk_bytes = layout(m_capacity);
+  while (m_chunk_bytes > CHUNK_SIZE && m_capacity > 1) {
+    m_chunk_bytes = layout(--m_capacity);
+  }
+  m_chunk_bytes = std::max(m_chunk_bytes, CHUNK_SIZE);
+}
+
+yacs::archetype::~archetype() {
+  for (size_t row = 0; row < m_size; ++row) {
+    destroy(row);
+  }
+  for (auto* chunk : m_chunks) {
+    ::operator delete(chunk, std::align_val_t(m_chunk_align));
+  }
+}
+
+size_t yacs::archetype::push(entity_id id) {
+  if (m_size == m_chunks.size() * m_capacity) {
+    m_chunks.push_back(static_cast<std::byte*>(
+        ::operator new(m_chunk_bytes, std::align_val_t(m_chunk_align))));
+  }
+  auto row = m_size++;
+  entity(row) = id;
+  return row;
+}
+
+bool yacs::archetype::remove(size_t row) {
+  auto last = --m_size;
+  bool moved = row != last;
+  if (moved) {
+    for (size_t column = 0; column < m_infos.size(); ++column) {
+      m_infos[column].relocate(at(row, column), at(last, column));
+    }
+    entity(row) = entity(last);
+  }
+  if (m_size % m_capacity == 0) {
+    ::operator delete(m_chunks.back(), std::align_val_t(m_chunk_align));
+    m_chunks.pop_back();
+  }
+  return moved;
+}
+
+void yacs::archetype::destroy(size_t row) {
+  for (size_t column = 0; column < m_infos.size(); ++column) {
+    m_infos[column].destroy(at(row, column));
+  }
+}
+
+size_t& yacs::archetype::edge(component_id id, bool add) {
+  auto& edges = add ? m_add_edges : m_remove_edges;
+  if (id >= edges.size()) {
+    edges.resize(id + 1, NO_ARCHETYPE);
+  }
+  return edges[id];
+}
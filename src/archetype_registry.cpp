@@ -0,0 +1,95 @@
+#include "archetype_registry.hpp"
+
+#include <algorithm>
+
+yacs::archetype_registry::archetype_registry() {
+  m_archetypes.emplace_back(new archetype({}, m_infos));
+}
+
+yacs::entity_id yacs::archetype_registry::create() {
+  entity_index index;
+  if (!m_free.empty()) {
+    index = m_free.back();
+    m_free.pop_back();
+  } else {
+    index = static_cast<entity_index>(m_entities.size());
+    m_entities.push_back({0, 0, 0});
+  }
+  auto& record = m_entities[index];
+  auto id = get_entity_id(index, record.version);
+  record.archetype = 0;
+  record.row = m_archetypes[0]->push(id);
+  return id;
+}
+
+bool yacs::archetype_registry::valid(entity_id id) const {
+  auto index = get_entity_index(id);
+  return index < m_entities.size() &&
+         m_entities[index].archetype != archetype::NO_ARCHETYPE &&
+         m_entities[index].version == get_entity_version(id);
+}
+
+void yacs::archetype_registry::destroy(entity_id id) {
+  auto index = get_entity_index(id);
+  auto& record = m_entities[index];
+  auto& source = *m_archetypes[record.archetype];
+  source.destroy(record.row);
+  if (source.remove(record.row)) {
+    m_entities[get_entity_index(source.entity(record.row))].row = record.row;
+  }
+  record.archetype = archetype::NO_ARCHETYPE;
+  ++record.version;
+  m_free.push_back(index);
+}
+
+size_t yacs::archetype_registry::transition(size_t from, component_id id,
+                                            bool add) {
+  auto edge = m_archetypes[from]->edge(id, add);
+  if (edge != archetype::NO_ARCHETYPE) {
+    return edge;
+  }
+  auto types = m_archetypes[from]->types();
+  if (add) {
+    types.insert(std::upper_bound(types.begin(), types.end(), id), id);
+  } else {
+    types.erase(std::find(types.begin(), types.end(), id));
+  }
+  auto target = find(std::move(types));
+  m_archetypes[from]->edge(id, add) = target;
+  m_archetypes[target]->edge(id, !add) = from;
+  return target;
+}
+
+size_t yacs::archetype_registry::find(vector<component_id> types) {
+  for (size_t i = 0; i < m_archetypes.size(); ++i) {
+    if (m_archetypes[i]->types() == types) {
+      return i;
+    }
+  }
+  m_archetypes.emplace_back(new archetype(std::move(types), m_infos));
+  return m_archetypes.size() - 1;
+}
+
+void yacs::archetype_registry::move(entity_index index, size_t target) {
+  auto& record = m_entities[index];
+  auto& source = *m_archetypes[record.archetype];
+  auto& destination = *m_archetypes[target];
+  auto row = destination.push(source.entity(record.row));
+
+  auto& types = source.types();
+  for (size_t column = 0; column < types.size(); ++column) {
+    auto to = destination.column(types[column]);
+    if (to == archetype::NO_COLUMN) {
+      m_infos[types[column]].destroy(source.at(record.row, column));
+    } else {
+      m_infos[types[column]].relocate(destination.at(row, to),
+                                      source.at(record.row, column));
+    }
+  }
+
+  if (source.remove(record.row)) {
+    m_entities[get_entity_index(source.entity(record.row))].row = record.row;
+  }
+  record.archetype = target;
+  record.row = row;
+}
@@ -0,0 +1,145 @@
+#include "command_buffer.hpp"
+
+#include <atomic>
+
+#include "entity.hpp"
+
+namespace {
+
+// Stamped into placeholder versions below PLACEHOLDER_BIT; it wraps after
+// 2^31 buffers, far beyond the number alive at once.
+std::atomic<yacs::entity_version> next_buffer_serial(0);
+
+// Queues get a serial instead of being keyed by address, so a queue built
+// where a destroyed one lived never sees its stale buffer.
+std::atomic<uint64_t> next_queue_serial(1);
+
+// The buffer each thread used last, so recording into one queue takes the
+// lock only on a thread's first call.
+struct cached_queue_buffer {
+  uint64_t serial = 0;
+  yacs::command_buffer* buffer = nullptr;
+};
+
+thread_local cached_queue_buffer cached_buffer;
+
+}  // namespace
+
+yacs::command_buffer::command_buffer()
+    : m_serial(next_buffer_serial.fetch_add(1, std::memory_order_relaxed) &
+               ~PLACEHOLDER_BIT),
+      m_created(0) {}
+
+yacs::entity_id yacs::command_buffer::create() {
+  return get_entity_id(static_cast<entity_index>(m_created++),
+                       placeholder_version());
+}
+
+void yacs::command_buffer::destroy(entity_id id) {
+  m_destroyed.push_back(id);
+}
+
+bool yacs::command_buffer::empty() const {
+  if (m_created > 0 || !m_destroyed.empty()) {
+    return false;
+  }
+  for (auto& commands : m_commands) {
+    if (commands && !commands->empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void yacs::command_buffer::clear() {
+  m_created = 0;
+  m_destroyed.clear();
+  for (auto& commands : m_commands) {
+    if (commands) {
+      commands->clear();
+    }
+  }
+}
+
+void yacs::command_buffer::flush(registry& registry) {
+  playback(registry, {this});
+}
+
+void yacs::command_buffer::playback(registry& registry,
+                                    const vector<command_buffer*>& buffers) {
+  vector<vector<entity_id>> created(buffers.size());
+  size_t pools = 0;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    created[i].reserve(buffers[i]->m_created);
+    for (size_t j = 0; j < buffers[i]->m_created; ++j) {
+      created[i].push_back(registry.create().id);
+    }
+    pools = std::max(pools, buffers[i]->m_commands.size());
+  }
+
+  for (size_t pool = 0; pool < pools; ++pool) {
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      auto& commands = buffers[i]->m_commands;
+      if (pool < commands.size() && commands[pool] &&
+          !commands[pool]->empty()) {
+        commands[pool]->apply(registry, buffers[i]->placeholder_version(),
+                              created[i]);
+      }
+    }
+  }
+
+  vector<entity_id> destroyed;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    for (auto id : buffers[i]->m_destroyed) {
+      destroyed.push_back(
+          resolve(id, buffers[i]->placeholder_version(), created[i]));
+    }
+  }
+  std::sort(destroyed.begin(), destroyed.end(), by_index);
+  destroyed.erase(std::unique(destroyed.begin(), destroyed.end()),
+                  destroyed.end());
+  for (auto id : destroyed) {
+    if (registry.valid(id)) {
+      registry.destroy(id);
+    }
+  }
+
+  for (auto* buffer : buffers) {
+    buffer->clear();
+  }
+}
+
+yacs::command_queue::command_queue()
+    : m_serial(next_queue_serial.fetch_add(1, std::memory_order_relaxed)) {}
+
+yacs::command_buffer& yacs::command_queue::local() {
+  if (cached_buffer.serial == m_serial) {
+    return *cached_buffer.buffer;
+  }
+  auto id = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  command_buffer* found = nullptr;
+  for (auto& buffer : m_buffers) {
+    if (buffer.first == id) {
+      found = buffer.second.get();
+      break;
+    }
+  }
+  if (!found) {
+    m_buffers.emplace_back(id, new command_buffer());
+    found = m_buffers.back().second.get();
+  }
+  cached_buffer.serial = m_serial;
+  cached_buffer.buffer = found;
+  return *found;
+}
+
+void yacs::command_queue::flush(registry& registry) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  vector<command_buffer*> buffers;
+  buffers.reserve(m_buffers.size());
+  for (auto& buffer : m_buffers) {
+    buffers.push_back(buffer.second.get());
+  }
+  command_buffer::playback(registry, buffers);
+}
@@ -0,0 +1,160 @@
+#include "types.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define YACS_MASK_SSE2
+#endif
+
+namespace {
+using yacs::component_mask;
+using yacs::entity_slot;
+
+yacs::entity_id id_of(const entity_slot& slot) {
+  return yacs::get_entity_id(slot.index, slot.version);
+}
+
+#if defined(__AVX2__) && YACS_MAX_COMPONENTS == 128
+const __m128i* lanes(const uint64_t* words) {
+  return reinterpret_cast<const __m128i*>(words);
+}
+
+// Two slots share one 256-bit register, so a single and/compare pass tests
+// both of them.
+size_t scan(const entity_slot* slots, size_t count,
+            const component_mask& include, const component_mask& exclude,
+            yacs::entity_id* out) {
+  auto inc =
+      _mm256_broadcastsi128_si256(_mm_load_si128(lanes(include.words())));
+  auto exc =
+      _mm256_broadcastsi128_si256(_mm_load_si128(lanes(exclude.words())));
+  auto zero = _mm256_setzero_si256();
+  size_t found = 0;
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    auto low = _mm_load_si128(lanes(slots[i].mask.words()));
+    auto high = _mm_load_si128(lanes(slots[i + 1].mask.words()));
+    auto mask = _mm256_set_m128i(high, low);
+    auto hit = _mm256_and_si256(
+        _mm256_cmpeq_epi64(_mm256_and_si256(mask, inc), inc),
+        _mm256_cmpeq_epi64(_mm256_and_si256(mask, exc), zero));
+    auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+    if ((bits & 0xFFFF) == 0xFFFF) {
+      out[found++] = id_of(slots[i]);
+    }
+    if ((bits >> 16) == 0xFFFF) {
+      out[found++] = id_of(slots[i + 1]);
+    }
+  }
+  if (i < count && slots[i].mask.includes(include) &&
+      !slots[i].mask.intersects(exclude)) {
+    out[found++] = id_of(slots[i]);
+  }
+  return found;
+}
+#elif defined(__AVX2__)
+const __m256i* lanes(const uint64_t* words) {
+  return reinterpret_cast<const __m256i*>(words);
+}
+
+// Two slots per pass, 256 bits of each mask per instruction. The two slots
+// keep independent and/compare chains so their loads and compares overlap.
+size_t scan(const entity_slot* slots, size_t count,
+            const component_mask& include, const component_mask& exclude,
+            yacs::entity_id* out) {
+  constexpr size_t LANES = component_mask::WORDS / 4;
+  __m256i inc[LANES];
+  __m256i exc[LANES];
+  for (size_t lane = 0; lane < LANES; ++lane) {
+    inc[lane] = _mm256_load_si256(lanes(include.words()) + lane);
+    exc[lane] = _mm256_load_si256(lanes(exclude.words()) + lane);
+  }
+  auto zero = _mm256_setzero_si256();
+  auto test = [&](__m256i hit, const entity_slot& slot, size_t lane) {
+    auto mask = _mm256_load_si256(lanes(slot.mask.words()) + lane);
+    return _mm256_and_si256(
+        hit, _mm256_and_si256(
+                 _mm256_cmpeq_epi64(_mm256_and_si256(mask, inc[lane]),
+                                    inc[lane]),
+                 _mm256_cmpeq_epi64(_mm256_and_si256(mask, exc[lane]), zero)));
+  };
+  size_t found = 0;
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    auto first = _mm256_set1_epi8(-1);
+    auto second = _mm256_set1_epi8(-1);
+    for (size_t lane = 0; lane < LANES; ++lane) {
+      first = test(first, slots[i], lane);
+      second = test(second, slots[i + 1], lane);
+    }
+    if (_mm256_movemask_epi8(first) == -1) {
+      out[found++] = id_of(slots[i]);
+    }
+    if (_mm256_movemask_epi8(second) == -1) {
+      out[found++] = id_of(slots[i + 1]);
+    }
+  }
+  if (i < count) {
+    auto hit = _mm256_set1_epi8(-1);
+    for (size_t lane = 0; lane < LANES; ++lane) {
+      hit = test(hit, slots[i], lane);
+    }
+    if (_mm256_movemask_epi8(hit) == -1) {
+      out[found++] = id_of(slots[i]);
+    }
+  }
+  return found;
+}
+#elif defined(YACS_MASK_SSE2)
+const __m128i* lanes(const uint64_t* words) {
+  return reinterpret_cast<const __m128i*>(words);
+}
+
+size_t scan(const entity_slot* slots, size_t count,
+            const component_mask& include, const component_mask& exclude,
+            yacs::entity_id* out) {
+  constexpr size_t LANES = component_mask::WORDS / 2;
+  __m128i inc[LANES];
+  __m128i exc[LANES];
+  for (size_t lane = 0; lane < LANES; ++lane) {
+    inc[lane] = _mm_load_si128(lanes(include.words()) + lane);
+    exc[lane] = _mm_load_si128(lanes(exclude.words()) + lane);
+  }
+  auto zero = _mm_setzero_si128();
+  size_t found = 0;
+  for (size_t i = 0; i < count; ++i) {
+    auto hit = _mm_set1_epi8(-1);
+    for (size_t lane = 0; lane < LANES; ++lane) {
+      auto mask = _mm_load_si128(lanes(slots[i].mask.words()) + lane);
+      hit = _mm_and_si128(
+          hit, _mm_and_si128(
+                   _mm_cmpeq_epi32(_mm_and_si128(mask, inc[lane]), inc[lane]),
+                   _mm_cmpeq_epi32(_mm_and_si128(mask, exc[lane]), zero)));
+    }
+    if (_mm_movemask_epi8(hit) == 0xFFFF) {
+      out[found++] = id_of(slots[i]);
+    }
+  }
+  return found;
+}
+#else
+size_t scan(const entity_slot* slots, size_t count,
+            const component_mask& include, const component_mask& exclude,
+            yacs::entity_id* out) {
+  size_t found = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (slots[i].mask.includes(include) && !slots[i].mask.intersects(exclude)) {
+      out[found++] = id_of(slots[i]);
+    }
+  }
+  return found;
+}
+#endif
+}  // namespace
+
+size_t yacs::match_slots(const entity_slot* slots, size_t count,
+                         const component_mask& include,
+                         const component_mask& exclude, entity_id* out) {
+  return scan(slots, count, include, exclude, out);
+}
@@ -0,0 +1,89 @@
+#include "concurrent_registry.hpp"
+
+namespace {
+
+std::atomic<uint64_t> next_serial(1);
+
+// Each thread remembers the stage it used last, so a worker adding into one
+// concurrent_registry only takes the lock on its first call.
+struct cached_stage {
+  uint64_t serial = 0;
+  void* stage = nullptr;
+};
+
+thread_local cached_stage cache;
+
+}  // namespace
+
+yacs::concurrent_registry::concurrent_registry(registry& registry)
+    : m_registry(registry),
+      m_reserved(0),
+      m_serial(next_serial.fetch_add(1, std::memory_order_relaxed)) {}
+
+yacs::entity_id yacs::concurrent_registry::create() {
+  auto index = pop_free();
+  if (index != registry::NO_FREE_SLOT) {
+    local().recycled.push_back(index);
+    return get_entity_id(index, version(index));
+  }
+  return get_entity_id(reserve(1), 0);
+}
+
+void yacs::concurrent_registry::sync() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto& entities = m_registry.m_entities;
+  vector<command_buffer*> buffers;
+  buffers.reserve(m_stages.size());
+  for (auto& entry : m_stages) {
+    auto& stage = *entry.second;
+    for (auto index : stage.recycled) {
+      entities[index].index = index;
+    }
+    stage.recycled.clear();
+    buffers.push_back(&stage.commands);
+  }
+
+  auto reserved = m_reserved.exchange(0, std::memory_order_relaxed);
+  if (reserved > 0) {
+    auto index = static_cast<entity_index>(entities.size());
+    entities.grow(reserved);
+    entities.reserve_sparse(index + reserved - 1);
+    for (auto last = index + reserved; index < last; ++index) {
+      entities.construct(index, entity_slot{index, 0, component_mask()});
+    }
+  }
+  command_buffer::playback(m_registry, buffers);
+}
+
+yacs::concurrent_registry::stage& yacs::concurrent_registry::local() {
+  if (cache.serial == m_serial) {
+    return *static_cast<stage*>(cache.stage);
+  }
+  auto id = std::this_thread::get_id();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  stage* found = nullptr;
+  for (auto& entry : m_stages) {
+    if (entry.first == id) {
+      found = entry.second.get();
+      break;
+    }
+  }
+  if (!found) {
+    m_stages.emplace_back(id, new stage());
+    found = m_stages.back().second.get();
+  }
+  cache.serial = m_serial;
+  cache.stage = found;
+  return *found;
+}
+
+yacs::entity_index yacs::concurrent_registry::pop_free() {
+  auto& head = m_registry.m_free_head;
+  auto index = head.load(std::memory_order_acquire);
+  while (index != registry::NO_FREE_SLOT &&
+         !head.compare_exchange_weak(
+             index, std::as_const(m_registry.m_entities)[index].index,
+             std::memory_order_acquire)) {
+  }
+  return index;
+}
@@ -0,0 +1,239 @@
+#include "delta.hpp"
+
+#include <algorithm>
+
+void yacs::write_varint(vector<uint8_t>& out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+bool yacs::delta_reader::varint(uint64_t& value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (m_position == m_size) {
+      return false;
+    }
+    auto byte = m_data[m_position++];
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool yacs::delta_reader::bytes(size_t count, const uint8_t*& data) {
+  if (count > remaining()) {
+    return false;
+  }
+  data = m_data + m_position;
+  m_position += count;
+  return true;
+}
+
+void yacs::xor_rle_encoder::push(const uint8_t* value, const uint8_t* baseline,
+                                 size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    uint8_t byte = baseline ? value[i] ^ baseline[i] : value[i];
+    if (byte == 0) {
+      end_literals();
+      if (++m_zeros == 0x80) {
+        flush_zeros();
+      }
+      continue;
+    }
+    flush_zeros();
+    if (m_literals == 0) {
+      m_control = m_out.size();
+      m_out.push_back(0x80);
+    }
+    m_out.push_back(byte);
+    m_out[m_control] = static_cast<uint8_t>(0x80 | m_literals);
+    if (++m_literals == 0x80) {
+      end_literals();
+    }
+  }
+}
+
+void yacs::xor_rle_encoder::finish() {
+  flush_zeros();
+  end_literals();
+}
+
+void yacs::xor_rle_encoder::flush_zeros() {
+  if (m_zeros > 0) {
+    m_out.push_back(static_cast<uint8_t>(m_zeros - 1));
+    m_zeros = 0;
+  }
+}
+
+void yacs::xor_rle_encoder::end_literals() {
+  m_literals = 0;
+}
+
+bool yacs::xor_rle_decoder::apply(uint8_t* target, size_t size) {
+  while (size > 0) {
+    if (m_zeros > 0) {
+      auto skip = std::min(m_zeros, size);
+      target += skip;
+      size -= skip;
+      m_zeros -= skip;
+    } else if (m_literals > 0) {
+      if (m_position == m_size) {
+        return false;
+      }
+      *target++ ^= m_data[m_position++];
+      --size;
+      --m_literals;
+    } else {
+      if (m_position == m_size) {
+        return false;
+      }
+      auto control = m_data[m_position++];
+      if (control & 0x80) {
+        m_literals = (control & 0x7f) + size_t(1);
+      } else {
+        m_zeros = control + size_t(1);
+      }
+    }
+  }
+  return true;
+}
+
+void yacs::delta::encode_entities(const registry& baseline,
+                                  const registry& current,
+                                  vector<uint8_t>& states,
+                                  vector<entity_index>& destroyed,
+                                  vector<uint8_t>& out) {
+  auto free_flags = [](const registry& registry) {
+    vector<uint8_t> flags(registry.m_entities.size(), 0);
+    registry.each_free([&flags](entity_index index) { flags[index] = 1; });
+    return flags;
+  };
+  auto was_free = free_flags(baseline);
+  auto is_free = free_flags(current);
+  auto before = baseline.m_entities.size();
+  auto after = current.m_entities.size();
+
+  destroyed.clear();
+  vector<pair<entity_index, entity_version>> created;
+  states.assign(std::max(before, after), 0);
+  for (entity_index i = 0; i < states.size(); ++i) {
+    bool was = i < before && !was_free[i];
+    bool is = i < after && !is_free[i];
+    auto old_version = was ? baseline.m_entities[i].version : 0;
+    auto new_version = is ? current.m_entities[i].version : 0;
+    if (was && (!is || old_version != new_version)) {
+      destroyed.push_back(i);
+      states[i] |= DESTROYED;
+    }
+    if (is && (!was || old_version != new_version)) {
+      created.emplace_back(i, new_version);
+      states[i] |= CREATED;
+    }
+  }
+
+  write_indices(out, destroyed.begin(), destroyed.end(),
+                [](entity_index index) { return index; });
+  write_indices(out, created.begin(), created.end(),
+                [](auto& entry) { return entry.first; });
+  for (auto& entry : created) {
+    write_varint(out, entry.second);
+  }
+}
+
+bool yacs::delta::apply_entities(registry& target, delta_reader& in) {
+  vector<pool::index_type> destroyed, created;
+  if (!read_indices(in, destroyed) || !read_indices(in, created)) {
+    return false;
+  }
+  vector<entity_version> versions(created.size());
+  for (auto& version : versions) {
+    uint64_t value;
+    if (!in.varint(value) || value > static_cast<entity_version>(-1)) {
+      return false;
+    }
+    version = static_cast<entity_version>(value);
+  }
+
+  // Validate against the free list before touching the registry, so a bad
+  // delta leaves the entities as they were.
+  auto& entities = target.m_entities;
+  vector<uint8_t> is_free(entities.size(), 0);
+  target.each_free([&is_free](entity_index index) { is_free[index] = 1; });
+  for (auto index : destroyed) {
+    if (index >= entities.size() || is_free[index]) {
+      return false;
+    }
+  }
+  for (auto index : destroyed) {
+    is_free[index] = 1;
+  }
+  for (auto index : created) {
+    if (index > static_cast<entity_index>(-1) ||
+        (index < entities.size() && !is_free[index])) {
+      return false;
+    }
+  }
+
+  for (auto index : destroyed) {
+    target.destroy(target.id(static_cast<entity_index>(index)));
+  }
+
+  // Created slots can sit anywhere in the free list, so it is unthreaded
+  // oldest first and rebuilt from what is still free afterwards.
+  vector<entity_index> free;
+  target.each_free([&free](entity_index index) { free.push_back(index); });
+  std::reverse(free.begin(), free.end());
+  target.set_free_head(registry::NO_FREE_SLOT);
+
+  for (size_t i = 0; i < created.size(); ++i) {
+    auto index = static_cast<entity_index>(created[i]);
+    if (index < entities.size()) {
+      entities[index].index = index;
+      entities[index].version = versions[i];
+      is_free[index] = 0;
+      continue;
+    }
+    auto first = static_cast<entity_index>(entities.size());
+    entities.grow(index + 1 - first);
+    entities.reserve_sparse(index);
+    for (auto slot = first; slot < index; ++slot) {
+      entities.construct(slot, entity_slot{slot, 0, component_mask()});
+      is_free.push_back(1);
+      free.push_back(slot);
+    }
+    entities.construct(index,
+                       entity_slot{index, versions[i], component_mask()});
+    is_free.push_back(0);
+  }
+
+  for (auto index : free) {
+    if (is_free[index]) {
+      target.push_free(entities[index], index);
+    }
+  }
+  return true;
+}
+
+bool yacs::delta::read_indices(delta_reader& in,
+                               vector<pool::index_type>& indices) {
+  uint64_t count;
+  if (!in.varint(count) || count > in.remaining()) {
+    return false;
+  }
+  indices.resize(count);
+  pool::index_type previous = 0;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    uint64_t gap;
+    if (!in.varint(gap) || (i > 0 && gap == 0)) {
+      return false;
+    }
+    indices[i] = previous + gap;
+    previous = indices[i];
+  }
+  return true;
+}
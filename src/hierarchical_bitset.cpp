@@ -0,0 +1,25 @@
+#include "hierarchical_bitset.hpp"
+
+#include <algorithm>
+
+void yacs::hierarchical_bitset::clear() {
+  for (auto& layer : m_layers) {
+    std::fill(layer.begin(), layer.end(), 0);
+  }
+}
+
+void yacs::hierarchical_bitset::grow(index_type index) {
+  auto words = std::max(index / WORD_BITS + 1, m_layers[0].size() * 2);
+  m_layers[0].resize(words, 0);
+  for (size_t layer = 1; m_layers[layer - 1].size() > 1; ++layer) {
+    words = (m_layers[layer - 1].size() + WORD_BITS - 1) / WORD_BITS;
+    if (layer == m_layers.size()) {
+      // The old top only ever used its first word, which the new layer
+      // summarizes in its first bit.
+      m_layers.emplace_back(words, 0);
+      m_layers[layer][0] = m_layers[layer - 1][0] != 0 ? 1 : 0;
+    } else {
+      m_layers[layer].resize(words, 0);
+    }
+  }
+}
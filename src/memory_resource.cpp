@@ -0,0 +1,76 @@
+#include "memory_resource.hpp"
+
+#include <cstdint>
+#include <new>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+size_t huge_page_bytes(size_t bytes) {
+  return (bytes + yacs::HUGE_PAGE_SIZE - 1) / yacs::HUGE_PAGE_SIZE *
+         yacs::HUGE_PAGE_SIZE;
+}
+
+}  // namespace
+
+yacs::huge_page_resource& yacs::huge_page_resource::shared() {
+  static huge_page_resource resource;
+  return resource;
+}
+
+void* yacs::huge_page_resource::do_allocate(size_t bytes, size_t alignment) {
+#if defined(_WIN32)
+  return m_upstream->allocate(bytes, alignment);
+#else
+  if (bytes < HUGE_PAGE_SIZE || alignment > HUGE_PAGE_SIZE) {
+    return m_upstream->allocate(bytes, alignment);
+  }
+  auto size = huge_page_bytes(bytes);
+  void* mapped = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+  mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+  if (mapped != MAP_FAILED) {
+    return mapped;
+  }
+
+  // Transparent huge pages only back 2 MiB aligned ranges, so map one page
+  // extra and trim both ends.
+  mapped = mmap(nullptr, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapped == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  auto* start = static_cast<char*>(mapped);
+  auto* aligned = reinterpret_cast<char*>(
+      huge_page_bytes(reinterpret_cast<uintptr_t>(start)));
+  auto head = static_cast<size_t>(aligned - start);
+  if (head > 0) {
+    munmap(start, head);
+  }
+  if (head < HUGE_PAGE_SIZE) {
+    munmap(aligned + size, HUGE_PAGE_SIZE - head);
+  }
+#if defined(MADV_HUGEPAGE)
+  madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+  return aligned;
+#endif
+}
+
+void yacs::huge_page_resource::do_deallocate(void* pointer, size_t bytes,
+                                             size_t alignment) {
+#if defined(_WIN32)
+  m_upstream->deallocate(pointer, bytes, alignment);
+#else
+  if (bytes < HUGE_PAGE_SIZE || alignment > HUGE_PAGE_SIZE) {
+    m_upstream->deallocate(pointer, bytes, alignment);
+    return;
+  }
+  munmap(pointer, huge_page_bytes(bytes));
+#endif
+}
@@ -0,0 +1,36 @@
+#include "observer.hpp"
+
+yacs::observer::~observer() {
+  disconnect();
+}
+
+bool yacs::observer::contains(entity_id id) const {
+  auto index = get_entity_index(id);
+  return m_entities.contains(index) && m_entities[index] == id;
+}
+
+void yacs::observer::clear() {
+  m_entities.destroy();
+}
+
+void yacs::observer::disconnect() {
+  for (auto& entry : m_subscriptions) {
+    entry.source->disconnect(entry.id);
+  }
+  m_subscriptions.clear();
+}
+
+yacs::observer& yacs::observer::connect(signal<pool::index_type>& source) {
+  auto id = source.connect([this](pool::index_type index) { collect(index); });
+  m_subscriptions.push_back(subscription{&source, id});
+  return *this;
+}
+
+void yacs::observer::collect(pool::index_type index) {
+  auto id = m_registry->id(static_cast<entity_index>(index));
+  if (m_entities.contains(index)) {
+    m_entities[index] = id;
+  } else {
+    m_entities.construct(index, id);
+  }
+}
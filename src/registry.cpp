@@ -2,10 +2,9 @@
 #include "entity.hpp"
 
 yacs::entity yacs::registry::create() {
-  if (m_free.size() > 0) {
-    entity_slot* slot = m_free.back();
-    m_free.pop_back();
-    return entity(get_entity_id(slot->index, slot->version), this);
+  if (free_head() != NO_FREE_SLOT) {
+    auto& slot = pop_free();
+    return entity(get_entity_id(slot.index, slot.version), this);
   }
   auto index = m_entities.size();
   auto& slot = m_entities.construct(index);
@@ -15,18 +14,22 @@ yacs::entity yacs::registry::create() {
   return entity(get_entity_id(slot.index, slot.version), this);
 }
 
+// A stale id must not touch the slot: the free list is threaded through
+// slot.index, so pushing a slot twice would hand its index out twice.
 void yacs::registry::destroy(entity_id id) {
+  if (!valid(id)) {
+    return;
+  }
   auto& slot = m_entities[get_entity_index(id)];
-  auto& mask = slot.mask;
-  for (auto i = 0; i < m_pools.size() && i < MAX_COMPONENTS; ++i) {
-    if (mask.test(i)) {
-      auto& pool = m_pools[i];
-      pool->destroy(slot.index);
-      mask.reset(i);
+  slot.mask.each([this, &slot](size_t i) {
+    if (m_owners[i]) {
+      m_owners[i]->on_destroy(slot.index);
     }
-  }
+    m_pools[i]->destroy(slot.index);
+  });
+  slot.mask.reset();
   ++slot.version;
-  m_free.push_back(&slot);
+  push_free(slot, slot.index);
 }
 
 void yacs::registry::destroy(entity entity) {
@@ -35,4 +38,129 @@ void yacs::registry::destroy(entity entity) {
 
 yacs::entity yacs::registry::get(entity_id id) {
   return entity(id, this);
-}
\ No newline at end of file
+}
+
+bool yacs::registry::valid(entity_id id) const {
+  auto index = get_entity_index(id);
+  return m_entities.contains(index) &&
+         m_entities[index].version == get_entity_version(id);
+}
+
+yacs::pool::tick_type yacs::registry::advance() {
+  auto tick = ++m_tick;
+  for (auto* pool : m_pools) {
+    if (pool) {
+      pool->set_tick(tick);
+    }
+  }
+  return tick;
+}
+
+yacs::entity_id yacs::registry::id(entity_index index) const {
+  return get_entity_id(index, m_entities[index].version);
+}
+
+vector<yacs::entity_id> yacs::registry::query(
+    const component_mask& include, const component_mask& exclude) const {
+  assert(include.any() && "a query needs at least one included component");
+  vector<entity_id> ids(m_entities.size());
+  ids.resize(match_slots(m_entities.raw(), m_entities.size(), include, exclude,
+                         ids.data()));
+  return ids;
+}
+
+vector<pair<yacs::entity_id, yacs::entity_id>> yacs::registry::merge(
+    registry& other) {
+  vector<uint8_t> is_free(other.m_entities.size());
+  other.each_free([&is_free](entity_index index) { is_free[index] = 1; });
+  vector<pair<entity_id, entity_id>> translation;
+  translation.reserve(other.m_entities.size());
+  auto* indices = other.m_entities.data();
+  for (size_t i = 0; i < other.m_entities.size(); ++i) {
+    if (!is_free[indices[i]]) {
+      translation.emplace_back(
+          other.id(static_cast<entity_index>(indices[i])), entity_id());
+    }
+  }
+  other.transfer(*this, translation);
+  return translation;
+}
+
+// Entities are visited in index order so the entity tables are walked
+// forwards, and bucketed by component so each pool moves its share in one
+// call, which takes the block path when the pool empties completely.
+void yacs::registry::transfer(registry& other,
+                              vector<pair<entity_id, entity_id>>& translation) {
+  assert(&other != this && "transfer within one registry");
+  auto n = translation.size();
+  vector<entity_id> created(n);
+  other.create(n, created.begin());
+  vector<entity_index> keys(n);
+  vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i) {
+    keys[i] = get_entity_index(translation[i].first);
+    order[i] = i;
+  }
+  radix_sort(keys, order);
+
+  vector<vector<pool::index_type>> sources(m_pools.size());
+  vector<vector<pool::index_type>> targets(m_pools.size());
+  for (size_t k = 0; k < n; ++k) {
+    auto i = order[k];
+    assert(valid(translation[i].first));
+    translation[i].second = created[k];
+    auto index = get_entity_index(translation[i].first);
+    auto target = get_entity_index(created[k]);
+    auto& mask = m_entities[index].mask;
+    other.m_entities[target].mask = mask;
+    mask.each([&](size_t component_index) {
+      sources[component_index].push_back(index);
+      targets[component_index].push_back(target);
+    });
+  }
+
+  for (size_t i = 0; i < m_pools.size(); ++i) {
+    if (sources[i].empty()) {
+      continue;
+    }
+    if (m_owners[i]) {
+      for (auto index : sources[i]) {
+        m_owners[i]->on_destroy(index);
+      }
+    }
+    auto* target = other.assure(i, *m_pools[i]);
+    m_pools[i]->transfer(*target, sources[i].data(), targets[i].data(),
+                         sources[i].size());
+    if (other.m_owners[i]) {
+      for (auto index : targets[i]) {
+        other.m_owners[i]->on_construct(index);
+      }
+    }
+  }
+
+  for (auto i : order) {
+    auto index = get_entity_index(translation[i].first);
+    auto& slot = m_entities[index];
+    slot.mask.reset();
+    ++slot.version;
+    push_free(slot, index);
+  }
+}
+
+yacs::pool* yacs::registry::assure(component_id component_index,
+                                   const pool& prototype) {
+  assert((m_parallel_systems.load(std::memory_order_relaxed) == 0 ||
+          (component_index < m_pools.size() && m_pools[component_index])) &&
+         "component registered while parallel systems run");
+  if (component_index >= m_pools.size()) {
+    m_pools.resize(component_index + 1, nullptr);
+  }
+  if (component_index >= m_owners.size()) {
+    m_owners.resize(component_index + 1, nullptr);
+  }
+  if (!m_pools[component_index]) {
+    m_pools[component_index] = prototype.create_empty(m_resource);
+    m_pools[component_index]->set_tick(tick());
+  }
+  return m_pools[component_index];
+}
@@ -0,0 +1,87 @@
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+bool intersects(const vector<yacs::component_id>& lhs,
+                const vector<yacs::component_id>& rhs) {
+  for (auto id : lhs) {
+    if (std::find(rhs.begin(), rhs.end(), id) != rhs.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+}  // namespace
+
+bool yacs::scheduler::conflicts(const system& lhs, const system& rhs) {
+  return lhs.exclusive || rhs.exclusive || intersects(lhs.writes, rhs.writes) ||
+         intersects(lhs.writes, rhs.reads) || intersects(lhs.reads, rhs.writes);
+}
+
+void yacs::scheduler::build() {
+  auto n = m_systems.size();
+  m_successors.assign(n, {});
+  m_predecessors.assign(n, 0);
+  for (size_t j = 0; j < n; ++j) {
+    for (size_t i = 0; i < j; ++i) {
+      if (conflicts(m_systems[i], m_systems[j])) {
+        m_successors[i].push_back(j);
+        ++m_predecessors[j];
+      }
+    }
+  }
+}
+
+void yacs::scheduler::run_system(system& system) {
+  tick_type tick;
+  if (system.exclusive) {
+    tick = m_registry.advance();
+  } else {
+    tick = ++m_registry.m_tick;
+    for (auto id : system.writes) {
+      m_registry.m_pools[id]->set_tick(tick);
+    }
+    ++m_registry.m_parallel_systems;
+  }
+  system.fn(m_registry, system.last_run);
+  if (!system.exclusive) {
+    --m_registry.m_parallel_systems;
+  }
+  system.last_run = tick;
+}
+
+void yacs::scheduler::run() {
+  build();
+  auto n = m_systems.size();
+  if (n == 0) {
+    return;
+  }
+
+  std::unique_ptr<std::atomic<size_t>[]> pending(new std::atomic<size_t>[n]);
+  for (size_t i = 0; i < n; ++i) {
+    pending[i].store(m_predecessors[i], std::memory_order_relaxed);
+  }
+  std::atomic<size_t> remaining(n);
+
+  function<void(size_t)> execute = [&](size_t index) {
+    run_system(m_systems[index]);
+    for (auto successor : m_successors[index]) {
+      if (pending[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_executor.submit([&execute, successor]() { execute(successor); });
+      }
+    }
+    m_executor.finish(remaining);
+  };
+
+  for (size_t i = 0; i < n; ++i) {
+    if (m_predecessors[i] == 0) {
+      m_executor.submit([&execute, i]() { execute(i); });
+    }
+  }
+  m_executor.wait(remaining);
+  // Writes made between frames get a tick newer than every system's run.
+  m_registry.advance();
+}
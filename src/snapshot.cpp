@@ -0,0 +1,219 @@
+#include "snapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'Y', 'A', 'C', 'S', 'S', 'N', 'A', 'P'};
+
+// Marks the entity table; component hashes are FNV-1a of a type name and
+// never hit zero in practice.
+constexpr uint64_t ENTITY_SECTION = 0;
+
+}  // namespace
+
+yacs::snapshot_writer::snapshot_writer(const char* path)
+    : m_file(path, std::ios::binary | std::ios::trunc) {}
+
+void yacs::snapshot_writer::seek(uint64_t offset) {
+  m_file.seekp(static_cast<std::streamoff>(offset));
+}
+
+uint64_t yacs::snapshot_writer::align() {
+  static const char padding[SNAPSHOT_ALIGNMENT] = {};
+  auto offset = tell();
+  auto remainder = offset % SNAPSHOT_ALIGNMENT;
+  if (remainder != 0) {
+    write(padding, SNAPSHOT_ALIGNMENT - remainder);
+    offset += SNAPSHOT_ALIGNMENT - remainder;
+  }
+  return offset;
+}
+
+void yacs::snapshot_writer::write(const void* data, size_t bytes) {
+  m_file.write(static_cast<const char*>(data),
+               static_cast<std::streamsize>(bytes));
+}
+
+yacs::snapshot_reader::snapshot_reader(const char* path)
+    : m_data(nullptr), m_size(0), m_cursor(0), m_mapped(false) {
+#if defined(_WIN32)
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return;
+  }
+  m_buffer.assign(std::istreambuf_iterator<char>(file),
+                  std::istreambuf_iterator<char>());
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+#else
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat info;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    // Every section is copied out right away, so fault the pages in up front.
+#if defined(MAP_POPULATE)
+    int flags = MAP_PRIVATE | MAP_POPULATE;
+#else
+    int flags = MAP_PRIVATE;
+#endif
+    void* mapped =
+        mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, flags, fd, 0);
+    if (mapped != MAP_FAILED) {
+      m_data = static_cast<const char*>(mapped);
+      m_size = static_cast<size_t>(info.st_size);
+      m_mapped = true;
+    }
+  }
+  close(fd);
+#endif
+}
+
+yacs::snapshot_reader::~snapshot_reader() {
+#if !defined(_WIN32)
+  if (m_mapped) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+#endif
+}
+
+bool yacs::snapshot_reader::read(void* out, size_t bytes) {
+  if (!contains(m_cursor, bytes)) {
+    return false;
+  }
+  std::memcpy(out, m_data + m_cursor, bytes);
+  m_cursor += bytes;
+  return true;
+}
+
+yacs::snapshot_header yacs::snapshot::write_entities(
+    snapshot_writer& out, const registry& registry,
+    vector<snapshot_section>& sections) {
+  auto& entities = registry.m_entities;
+  auto& section = sections[0];
+  section.hash = ENTITY_SECTION;
+  section.size = sizeof(entity_slot);
+  section.flags = snapshot_section::RAW;
+  section.count = entities.size();
+  section.indices = out.align();
+  out.write(entities.data(), entities.size() * sizeof(pool::index_type));
+  section.values = out.align();
+  out.write(entities.raw(), entities.size() * sizeof(entity_slot));
+  section.bytes = out.tell() - section.values;
+
+  snapshot_header header{};
+  std::copy(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC),
+            header.magic);
+  header.version = SNAPSHOT_VERSION;
+  header.sections = static_cast<uint32_t>(sections.size());
+  header.index_size = sizeof(pool::index_type);
+  header.free_count = 0;
+  header.free_offset = out.align();
+  registry.each_free([&out, &header](entity_index index) {
+    out.write(index);
+    ++header.free_count;
+  });
+  return header;
+}
+
+bool yacs::snapshot::read_entities(snapshot_reader& in, registry& registry,
+                                   vector<snapshot_section>& sections) {
+  snapshot_header header;
+  if (!in.good() || !in.read(&header, sizeof(header)) ||
+      !std::equal(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC),
+                  header.magic) ||
+      header.version != SNAPSHOT_VERSION || header.sections == 0 ||
+      header.index_size != sizeof(pool::index_type)) {
+    return false;
+  }
+  sections.resize(header.sections);
+  if (!in.read(sections.data(), sections.size() * sizeof(snapshot_section))) {
+    return false;
+  }
+  for (auto& section : sections) {
+    auto raw = section.flags == snapshot_section::RAW;
+    if (!in.contains(section.indices, section.count, header.index_size,
+                     alignof(pool::index_type)) ||
+        !in.contains(section.values, section.bytes) ||
+        (raw && (!in.contains(section.values, section.count, section.size, 1) ||
+                 section.bytes != section.count * section.size))) {
+      return false;
+    }
+  }
+  auto& table = sections[0];
+  if (table.hash != ENTITY_SECTION || table.size != sizeof(entity_slot) ||
+      table.values % alignof(entity_slot) != 0 ||
+      !in.contains(header.free_offset, header.free_count,
+                   sizeof(entity_index), alignof(entity_index))) {
+    return false;
+  }
+
+  // Slots are never removed from the table, so its indices are a
+  // permutation of [0, count).
+  auto* indices =
+      reinterpret_cast<const pool::index_type*>(in.data() + table.indices);
+  vector<uint8_t> seen(table.count, 0);
+  for (size_t i = 0; i < table.count; ++i) {
+    if (indices[i] >= table.count || seen[indices[i]]) {
+      return false;
+    }
+    seen[indices[i]] = 1;
+  }
+
+  auto& entities = registry.m_entities;
+  auto* slots = reinterpret_cast<const entity_slot*>(in.data() + table.values);
+  entities.assign(indices, slots, table.count);
+  // Mask bits are component ids of the saving process; they are rebuilt
+  // from the pools as those are read.
+  for (size_t i = 0; i < entities.size(); ++i) {
+    entities.raw()[i].mask.reset();
+  }
+  // The list is saved head first; a repeated index would make it a cycle.
+  auto* free = reinterpret_cast<const entity_index*>(in.data() +
+                                                      header.free_offset);
+  vector<uint8_t> listed(entities.size(), 0);
+  for (auto i = header.free_count; i > 0; --i) {
+    auto index = free[i - 1];
+    if (!entities.contains(index) || listed[index]) {
+      return false;
+    }
+    listed[index] = 1;
+    registry.push_free(entities[index], index);
+  }
+  return true;
+}
+
+const yacs::snapshot_section* yacs::snapshot::find(
+    const vector<snapshot_section>& sections, uint64_t hash) {
+  auto it = std::find_if(
+      sections.begin() + 1, sections.end(),
+      [hash](const snapshot_section& section) { return section.hash == hash; });
+  return it == sections.end() ? nullptr : &*it;
+}
+
+bool yacs::snapshot::claim(registry& registry, const pool::index_type* indices,
+                           size_t count, component_id id) {
+  auto& entities = registry.m_entities;
+  for (size_t i = 0; i < count; ++i) {
+    auto index = indices[i];
+    // Free slots hold the next free index, never their own.
+    if (!entities.contains(index) || entities[index].index != index ||
+        entities[index].mask.test(id)) {
+      return false;
+    }
+    entities[index].mask.set(id);
+  }
+  return true;
+}
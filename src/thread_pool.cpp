@@ -0,0 +1,151 @@
+#include "thread_pool.hpp"
+
+namespace {
+thread_local const yacs::thread_pool* t_owner = nullptr;
+thread_local size_t t_queue = 0;
+}  // namespace
+
+yacs::thread_pool::thread_pool(size_t workers)
+    : m_pending(0), m_next_queue(0), m_stop(false) {
+  m_queues.reserve(workers + 1);
+  for (size_t i = 0; i <= workers; ++i) {
+    m_queues.emplace_back(new task_queue());
+  }
+  m_workers.reserve(workers);
+  for (size_t i = 0; i < workers; ++i) {
+    m_workers.emplace_back([this, i]() { work(i); });
+  }
+}
+
+yacs::thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_condition.notify_all();
+  for (auto& worker : m_workers) {
+    worker.join();
+  }
+}
+
+void yacs::thread_pool::submit(function<void()> task) {
+  auto index = current_queue();
+  if (index == m_workers.size() && !m_workers.empty()) {
+    index = m_next_queue.fetch_add(1, std::memory_order_relaxed) %
+            m_workers.size();
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.fetch_add(1, std::memory_order_release);
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+    m_queues[index]->tasks.push_back(std::move(task));
+  }
+  m_condition.notify_one();
+}
+
+bool yacs::thread_pool::run_pending() {
+  function<void()> task;
+  auto index = current_queue();
+  if (!pop(index, task) && !steal(index, task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+void yacs::thread_pool::wait(const std::atomic<size_t>& remaining) {
+  size_t spins = 0;
+  while (remaining.load(std::memory_order_acquire) > 0) {
+    if (run_pending()) {
+      spins = 0;
+      continue;
+    }
+    if (++spins < SPIN_LIMIT) {
+      std::this_thread::yield();
+      continue;
+    }
+    spins = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this, &remaining]() {
+      return remaining.load(std::memory_order_acquire) == 0 ||
+             m_pending.load(std::memory_order_acquire) > 0;
+    });
+  }
+}
+
+// The notification goes out under m_mutex, so it cannot slip in between a
+// waiter's last check and its sleep. Only members are touched once
+// remaining hits zero, since the waiter may return and release it.
+void yacs::thread_pool::finish(std::atomic<size_t>& remaining) {
+  if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_condition.notify_all();
+  }
+}
+
+void yacs::thread_pool::work(size_t index) {
+  t_owner = this;
+  t_queue = index;
+  for (size_t spins = 0;;) {
+    function<void()> task;
+    if (pop(index, task) || steal(index, task)) {
+      task();
+      spins = 0;
+      continue;
+    }
+    if (++spins < SPIN_LIMIT) {
+      std::this_thread::yield();
+      continue;
+    }
+    spins = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this]() {
+      return m_stop || m_pending.load(std::memory_order_acquire) > 0;
+    });
+    if (m_stop && m_pending.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+bool yacs::thread_pool::pop(size_t index, function<void()>& task) {
+  auto& queue = *m_queues[index];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  m_pending.fetch_sub(1, std::memory_order_acq_rel);
+  return true;
+}
+
+bool yacs::thread_pool::steal(size_t index, function<void()>& task) {
+  for (size_t i = 1; i < m_queues.size(); ++i) {
+    auto& queue = *m_queues[(index + i) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      m_pending.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t yacs::thread_pool::current_queue() const {
+  return t_owner == this ? t_queue : m_workers.size();
+}
+
+yacs::thread_pool& yacs::thread_pool::shared() {
+  static thread_pool pool;
+  return pool;
+}
+
+size_t yacs::thread_pool::default_workers() {
+  auto threads = std::thread::hardware_concurrency();
+  return threads > 1 ? threads - 1 : 0;
+}
@@ -1,6 +1,18 @@
 #include "types.hpp"
 
-yacs::component_id yacs::g_component_id_counter = 0;
+#include <cstdio>
+#include <cstdlib>
+
+yacs::component_id yacs::g_component_id_counter = STATIC_COMPONENTS;
+
+yacs::component_id yacs::next_component_id() {
+  if (g_component_id_counter >= MAX_COMPONENTS) {
+    std::fputs("yacs: too many component types, raise YACS_MAX_COMPONENTS\n",
+               stderr);
+    std::abort();
+  }
+  return g_component_id_counter++;
+}
 
 yacs::entity_id yacs::get_entity_id(entity_index index,
                                     entity_version version) {
@@ -0,0 +1,105 @@
+#include "archetype_registry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "data_struct.hpp"
+
+typedef struct position {
+  position(int x, int y) : x(x), y(y) {}
+  int x;
+  int y;
+} position;
+
+typedef struct velocity {
+  velocity(int dx) : dx(dx) {}
+  int dx;
+} velocity;
+
+TEST(archetype, chunk_layout_fits_chunk_size) {
+  std::vector<yacs::column_info> infos(2);
+  infos[0] = yacs::column_info::of<position>();
+  infos[1] = yacs::column_info::of<velocity>();
+  yacs::archetype archetype({0, 1}, infos);
+  EXPECT_EQ(archetype.capacity(),
+            yacs::CHUNK_SIZE /
+                (sizeof(yacs::entity_id) + sizeof(position) + sizeof(velocity)));
+  EXPECT_EQ(archetype.column(1), 1u);
+  EXPECT_EQ(archetype.column(2), yacs::archetype::NO_COLUMN);
+}
+
+TEST(archetype_registry, add_get_remove_move_between_archetypes) {
+  yacs::archetype_registry registry;
+  auto a = registry.create();
+  auto b = registry.create();
+  registry.add<position>(a, 1, 2);
+  registry.add<position>(b, 3, 4);
+  registry.add<velocity>(b, 5);
+
+  EXPECT_TRUE(registry.has<position>(a));
+  EXPECT_FALSE(registry.has<velocity>(a));
+  EXPECT_EQ(registry.get<position>(b).x, 3);
+  EXPECT_EQ(registry.get<velocity>(b).dx, 5);
+  EXPECT_EQ(registry.archetype_count(), 3u);
+
+  registry.destroy<position>(b);
+  EXPECT_FALSE(registry.has<position>(b));
+  EXPECT_EQ(registry.get<velocity>(b).dx, 5);
+  EXPECT_EQ(registry.get<position>(a).y, 2);
+  EXPECT_EQ(registry.archetype_count(), 4u);
+
+  registry.destroy(a);
+  EXPECT_FALSE(registry.valid(a));
+  EXPECT_TRUE(registry.valid(b));
+  EXPECT_EQ(registry.size(), 1u);
+}
+
+TEST(archetype_registry, each_spans_chunks_and_archetypes) {
+  yacs::archetype_registry registry;
+  std::vector<yacs::entity_id> ids;
+  for (int i = 0; i < 5000; ++i) {
+    auto id = registry.create();
+    registry.add<position>(id, i, 0);
+    if (i % 2 == 0) {
+      registry.add<velocity>(id, 1);
+    }
+    ids.push_back(id);
+  }
+
+  registry.each<position, const velocity>(
+      [](position& pos, const velocity& vel) { pos.y += vel.dx; });
+
+  size_t visited = 0;
+  registry.each<position>([&](yacs::entity_id id, position& pos) {
+    EXPECT_EQ(registry.get<position>(id).x, pos.x);
+    EXPECT_EQ(pos.y, pos.x % 2 == 0 ? 1 : 0);
+    ++visited;
+  });
+  EXPECT_EQ(visited, ids.size());
+
+  for (size_t i = 0; i < ids.size(); i += 3) {
+    registry.destroy(ids[i]);
+  }
+  std::atomic<size_t> moving(0);
+  registry.parallel_each<velocity>([&](velocity&) { ++moving; });
+  EXPECT_EQ(moving.load(), 1666u);
+}
+
+TEST(archetype_registry, destroys_non_trivial_components) {
+  yacs::archetype_registry registry;
+  for (int i = 0; i < 100; ++i) {
+    auto id = registry.create();
+    registry.add<data_struct>(id, i, i);
+    if (i % 3 == 0) {
+      registry.add<velocity>(id, i);
+    }
+    if (i % 5 == 0) {
+      registry.destroy(id);
+    }
+  }
+  int sum = 0;
+  registry.each<data_struct>([&](data_struct& data) { sum += *data.x; });
+  EXPECT_EQ(sum, 4950 - 950);
+}
@@ -0,0 +1,71 @@
+#include "basic_registry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "data_struct.hpp"
+
+typedef struct position {
+  position(int x, int y) : x(x), y(y) {}
+  int x;
+  int y;
+} position;
+
+typedef struct velocity {
+  velocity(int dx) : dx(dx) {}
+  int dx;
+} velocity;
+
+using world = yacs::basic_registry<position, velocity, data_struct>;
+
+static_assert(world::holds<velocity>, "velocity is part of the world");
+static_assert(!world::holds<int>, "int is not part of the world");
+
+TEST(basic_registry, add_get_destroy) {
+  world registry;
+  auto a = registry.create();
+  auto b = registry.create();
+  registry.add<position>(a, 1, 2);
+  registry.add<velocity>(a, 3);
+  registry.add<data_struct>(a, 4, 5);
+  registry.add<position>(b, 6, 7);
+
+  EXPECT_TRUE(registry.has<velocity>(a));
+  EXPECT_FALSE(registry.has<velocity>(b));
+  EXPECT_EQ(registry.get<position>(b).x, 6);
+
+  registry.destroy(a);
+  EXPECT_FALSE(registry.valid(a));
+  EXPECT_TRUE(registry.valid(b));
+  EXPECT_EQ(registry.storage<position>().size(), 1u);
+  EXPECT_TRUE(registry.storage<velocity>().empty());
+  EXPECT_TRUE(registry.storage<data_struct>().empty());
+
+  auto c = registry.create();
+  EXPECT_EQ(yacs::get_entity_index(c), yacs::get_entity_index(a));
+  EXPECT_EQ(yacs::get_entity_version(c), 1u);
+}
+
+TEST(basic_registry, bulk_and_view) {
+  world registry;
+  std::vector<yacs::entity_id> ids;
+  registry.create(100, std::back_inserter(ids));
+  for (size_t i = 0; i < ids.size(); ++i) {
+    registry.add<position>(ids[i], static_cast<int>(i), 0);
+    if (i % 4 == 0) {
+      registry.add<velocity>(ids[i], 1);
+    }
+  }
+
+  registry.view<position, const velocity>().each(
+      [](position& p, const velocity& v) { p.y += v.dx; });
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(registry.get<position>(ids[i]).y, i % 4 == 0 ? 1 : 0);
+  }
+
+  registry.destroy(ids.begin(), ids.begin() + 50);
+  EXPECT_EQ(registry.size(), 50u);
+  EXPECT_EQ(registry.storage<position>().size(), 50u);
+  EXPECT_EQ(registry.storage<velocity>().size(), 12u);
+}
@@ -0,0 +1,172 @@
+#include "command_buffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "entity.hpp"
+
+typedef struct position {
+  position(int x) : x(x) {}
+  int x;
+} position;
+
+typedef struct velocity {
+  velocity(int dx) : dx(dx) {}
+  int dx;
+} velocity;
+
+TEST(command_buffer, records_without_touching_registry) {
+  yacs::registry registry;
+  yacs::command_buffer buffer;
+
+  auto id = buffer.create();
+  buffer.add<position>(id, 1);
+  EXPECT_TRUE(yacs::command_buffer::placeholder(id));
+  EXPECT_FALSE(buffer.empty());
+  EXPECT_EQ(registry.storage<position>().size(), 0u);
+
+  buffer.flush(registry);
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(registry.storage<position>().size(), 1u);
+  EXPECT_EQ(registry.storage<position>().begin()->x, 1);
+}
+
+TEST(command_buffer, applies_adds_removes_and_destroys) {
+  yacs::registry registry;
+  yacs::entity_id ids[4];
+  for (yacs::entity_index i = 0; i < 4; ++i) {
+    registry.create().add<position>(0);
+    ids[i] = yacs::get_entity_id(i, 0);
+  }
+
+  yacs::command_buffer buffer;
+  buffer.add<velocity>(ids[3], 3);
+  buffer.add<velocity>(ids[1], 1);
+  buffer.add<position>(ids[2], 7);
+  buffer.remove<position>(ids[0]);
+  buffer.destroy(ids[1]);
+  buffer.destroy(ids[1]);
+  buffer.flush(registry);
+
+  EXPECT_FALSE(registry.has<position>(ids[0]));
+  EXPECT_EQ(registry.get<position>(ids[2]).x, 7);
+  EXPECT_EQ(registry.get<velocity>(ids[3]).dx, 3);
+  EXPECT_FALSE(registry.valid(ids[1]));
+  EXPECT_FALSE(registry.has<velocity>(ids[1]));
+  EXPECT_EQ(registry.storage<velocity>().size(), 1u);
+}
+
+TEST(command_buffer, skips_stale_entities) {
+  yacs::registry registry;
+  registry.create();
+  auto id = yacs::get_entity_id(0, 0);
+  registry.destroy(id);
+
+  yacs::command_buffer buffer;
+  buffer.add<position>(id, 1);
+  buffer.destroy(id);
+  buffer.flush(registry);
+  EXPECT_EQ(registry.storage<position>().size(), 0u);
+}
+
+TEST(command_buffer, keeps_add_remove_order_per_entity) {
+  yacs::registry registry;
+  yacs::entity_id ids[2];
+  registry.create(2, ids);
+  registry.add<position>(ids[1], 5);
+
+  yacs::command_buffer buffer;
+  buffer.add<position>(ids[0], 1);
+  buffer.remove<position>(ids[0]);
+  buffer.remove<position>(ids[1]);
+  buffer.add<position>(ids[1], 2);
+  buffer.flush(registry);
+
+  EXPECT_FALSE(registry.has<position>(ids[0]));
+  EXPECT_EQ(registry.get<position>(ids[1]).x, 2);
+}
+
+TEST(command_buffer, re_add_replaces_and_notifies) {
+  yacs::registry registry;
+  yacs::entity_id id;
+  registry.create(1, &id);
+  registry.add<position>(id, 1);
+  size_t updates = 0;
+  registry.on_update<position>().connect(
+      [&updates](yacs::pool::index_type) { ++updates; });
+
+  yacs::command_buffer buffer;
+  buffer.add<position>(id, 3);
+  yacs::command_buffer other;
+  buffer.add<position>(other.create(), 4);
+  buffer.flush(registry);
+
+  EXPECT_EQ(registry.get<position>(id).x, 3);
+  EXPECT_EQ(updates, 1u);
+  EXPECT_EQ(registry.storage<position>().size(), 1u);
+}
+
+TEST(command_buffer, rejects_placeholders_of_other_buffers) {
+  yacs::registry registry;
+  yacs::command_buffer first, second;
+  auto mine = first.create();
+  auto theirs = second.create();
+  EXPECT_EQ(yacs::get_entity_index(mine), yacs::get_entity_index(theirs));
+  EXPECT_NE(mine, theirs);
+
+  first.add<position>(mine, 1);
+  first.add<velocity>(theirs, 2);
+  first.destroy(theirs);
+  first.flush(registry);
+  EXPECT_EQ(registry.storage<position>().size(), 1u);
+  EXPECT_EQ(registry.storage<velocity>().size(), 0u);
+  auto created = registry.id(0);
+  EXPECT_TRUE(registry.valid(created));
+  EXPECT_EQ(registry.get<position>(created).x, 1);
+  EXPECT_FALSE(registry.has<velocity>(created));
+}
+
+TEST(command_queue, merges_thread_local_buffers) {
+  yacs::registry registry;
+  yacs::command_queue queue;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&queue, t]() {
+      auto& buffer = queue.local();
+      for (int i = 0; i < 100; ++i) {
+        auto id = buffer.create();
+        buffer.add<position>(id, t);
+        buffer.add<velocity>(id, i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  queue.flush(registry);
+  EXPECT_EQ(registry.storage<position>().size(), 400u);
+  EXPECT_EQ(registry.storage<velocity>().size(), 400u);
+  EXPECT_EQ((registry.view<position, velocity>().size_hint()), 400u);
+}
+
+TEST(command_queue, local_buffer_is_per_thread_and_queue) {
+  auto first = std::make_unique<yacs::command_queue>();
+  yacs::command_queue second;
+  auto* buffer = &first->local();
+  EXPECT_EQ(&first->local(), buffer);
+  EXPECT_NE(&second.local(), buffer);
+
+  yacs::command_buffer* other = nullptr;
+  std::thread([&] { other = &first->local(); }).join();
+  EXPECT_NE(other, buffer);
+
+  first = std::make_unique<yacs::command_queue>();
+  first->local().create();
+  EXPECT_FALSE(first->local().empty());
+  EXPECT_TRUE(second.local().empty());
+}
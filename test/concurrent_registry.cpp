@@ -0,0 +1,98 @@
+#include "concurrent_registry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "entity.hpp"
+
+struct position {
+  int x;
+  int y;
+};
+
+TEST(concurrent_registry_test, ids_become_valid_on_sync) {
+  yacs::registry registry;
+  yacs::concurrent_registry concurrent(registry);
+  auto id = concurrent.create();
+  concurrent.add<position>(id, position{1, 2});
+  ASSERT_FALSE(registry.valid(id));
+
+  concurrent.sync();
+  ASSERT_TRUE(registry.valid(id));
+  ASSERT_EQ(registry.get<position>(id).y, 2);
+  ASSERT_TRUE(registry.valid(yacs::get_entity_id(0, 0)));
+  ASSERT_FALSE(registry.valid(yacs::get_entity_id(1, 0)));
+}
+
+TEST(concurrent_registry_test, recycles_free_slots_first) {
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+  registry.create(5, std::back_inserter(ids));
+  registry.destroy(ids[1]);
+  registry.destroy(ids[3]);
+
+  yacs::concurrent_registry concurrent(registry);
+  std::vector<yacs::entity_id> created;
+  concurrent.create(3, std::back_inserter(created));
+  ASSERT_EQ(created, (std::vector<yacs::entity_id>{
+                         yacs::get_entity_id(3, 1), yacs::get_entity_id(1, 1),
+                         yacs::get_entity_id(5, 0)}));
+  concurrent.sync();
+  for (auto id : created) {
+    ASSERT_TRUE(registry.valid(id));
+  }
+  ASSERT_FALSE(registry.valid(yacs::get_entity_id(6, 0)));
+  registry.create();
+  ASSERT_TRUE(registry.valid(yacs::get_entity_id(6, 0)));
+
+  registry.destroy(created[0]);
+  ASSERT_EQ(concurrent.create(), yacs::get_entity_id(3, 2));
+  concurrent.sync();
+  ASSERT_TRUE(registry.valid(yacs::get_entity_id(3, 2)));
+}
+
+TEST(concurrent_registry_test, threads_create_and_add) {
+  constexpr int THREADS = 4;
+  constexpr int PER_THREAD = 5000;
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+  registry.create(1000, std::back_inserter(ids));
+  registry.destroy(ids.begin(), ids.end());
+
+  yacs::concurrent_registry concurrent(registry);
+  std::vector<std::vector<yacs::entity_id>> created(THREADS);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&concurrent, &created, t] {
+      for (int i = 0; i < PER_THREAD; ++i) {
+        auto id = concurrent.create();
+        concurrent.add<position>(id, position{t, i});
+        created[t].push_back(id);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  concurrent.sync();
+
+  std::vector<yacs::entity_index> indices;
+  for (int t = 0; t < THREADS; ++t) {
+    for (int i = 0; i < PER_THREAD; ++i) {
+      auto id = created[t][i];
+      ASSERT_TRUE(registry.valid(id));
+      ASSERT_EQ(registry.get<position>(id).x, t);
+      ASSERT_EQ(registry.get<position>(id).y, i);
+      indices.push_back(yacs::get_entity_index(id));
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+  ASSERT_TRUE(std::adjacent_find(indices.begin(), indices.end()) ==
+              indices.end());
+  ASSERT_EQ(indices.back(), THREADS * PER_THREAD - 1);
+  ASSERT_EQ(registry.storage<position>().size(), THREADS * PER_THREAD);
+}
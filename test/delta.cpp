@@ -0,0 +1,210 @@
+#include "delta.hpp"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <vector>
+
+#include "registry.hpp"
+
+struct position {
+  int x;
+  int y;
+};
+
+struct health {
+  float value;
+};
+
+static bool same(yacs::registry& left, yacs::registry& right,
+                 const std::vector<yacs::entity_id>& ids) {
+  for (auto id : ids) {
+    if (left.valid(id) != right.valid(id)) {
+      return false;
+    }
+    if (!left.valid(id)) {
+      continue;
+    }
+    if (left.has<position>(id) != right.has<position>(id) ||
+        left.has<health>(id) != right.has<health>(id)) {
+      return false;
+    }
+    if (left.has<position>(id) &&
+        (left.get<position>(id).x != right.get<position>(id).x ||
+         left.get<position>(id).y != right.get<position>(id).y)) {
+      return false;
+    }
+    if (left.has<health>(id) &&
+        left.get<health>(id).value != right.get<health>(id).value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(xor_rle_test, round_trip) {
+  std::vector<uint8_t> before(1000), after(1000);
+  for (size_t i = 0; i < before.size(); ++i) {
+    before[i] = static_cast<uint8_t>(i * 7);
+    after[i] = i % 97 < 3 || (i > 500 && i < 700) ? static_cast<uint8_t>(i)
+                                                  : before[i];
+  }
+  std::vector<uint8_t> stream;
+  yacs::xor_rle_encoder encoder(stream);
+  encoder.push(after.data(), before.data(), 300);
+  encoder.push(after.data() + 300, before.data() + 300, 700);
+  encoder.finish();
+  ASSERT_LT(stream.size(), 300);
+
+  yacs::xor_rle_decoder decoder(stream.data(), stream.size());
+  ASSERT_TRUE(decoder.apply(before.data(), 999));
+  ASSERT_TRUE(decoder.apply(before.data() + 999, 1));
+  ASSERT_EQ(before, after);
+  ASSERT_TRUE(decoder.done());
+  ASSERT_FALSE(decoder.apply(before.data(), 1));
+}
+
+// A delta adding one position to id, decoded from stream.
+static std::vector<uint8_t> position_delta(yacs::entity_id id,
+                                           const std::vector<uint8_t>& stream) {
+  std::vector<uint8_t> out;
+  yacs::write_varint(out, 0);
+  yacs::write_varint(out, 0);
+  yacs::write_varint(out, 1);
+  auto hash = yacs::component_traits<position>::hash;
+  auto* bytes = reinterpret_cast<const uint8_t*>(&hash);
+  out.insert(out.end(), bytes, bytes + sizeof(hash));
+  yacs::write_varint(out, 0);
+  yacs::write_varint(out, 1);
+  yacs::write_varint(out, yacs::get_entity_index(id));
+  yacs::write_varint(out, 0);
+  yacs::write_varint(out, stream.size());
+  out.insert(out.end(), stream.begin(), stream.end());
+  return out;
+}
+
+class delta_test : public ::testing::Test {
+ protected:
+  void SetUp() {
+    world.create(100, std::back_inserter(ids));
+    for (int i = 0; i < 100; ++i) {
+      world.add<position>(ids[i], position{i, -i});
+      if (i % 4 == 0) {
+        world.add<health>(ids[i], health{100.f});
+      }
+    }
+    sync();
+  }
+
+  void sync() {
+    yacs::delta::encode<position, health>(baseline, world, bytes);
+    ASSERT_TRUE((yacs::delta::apply<position, health>(baseline, bytes.data(),
+                                                      bytes.size())));
+    ASSERT_TRUE((yacs::delta::apply<position, health>(remote, bytes.data(),
+                                                      bytes.size())));
+  }
+
+  yacs::registry world;
+  yacs::registry baseline;
+  yacs::registry remote;
+  std::vector<yacs::entity_id> ids;
+  std::vector<uint8_t> bytes;
+};
+
+TEST_F(delta_test, initial_state) {
+  ASSERT_TRUE(same(world, remote, ids));
+  ASSERT_TRUE(same(world, baseline, ids));
+  ASSERT_EQ(remote.query(yacs::registry::mask<position, health>()).size(), 25);
+}
+
+TEST_F(delta_test, unchanged_world_encodes_small) {
+  yacs::delta::encode<position, health>(baseline, world, bytes);
+  ASSERT_LT(bytes.size(), 32);
+}
+
+TEST_F(delta_test, changes_recycling_and_components) {
+  world.get<position>(ids[3]).x = 1000;
+  world.patch<health>(ids[8], [](health& h) { h.value -= 10.f; });
+  world.destroy<health>(ids[12]);
+  world.add<health>(ids[13], health{50.f});
+  world.destroy(ids[20]);
+  world.destroy(ids[21]);
+  std::vector<yacs::entity_id> recycled;
+  world.create(1, std::back_inserter(recycled));
+  world.add<position>(recycled[0], position{7, 7});
+  world.create(3, std::back_inserter(recycled));
+  world.add<health>(recycled.back(), health{1.f});
+  ids.insert(ids.end(), recycled.begin(), recycled.end());
+
+  sync();
+  ASSERT_TRUE(same(world, remote, ids));
+  ASSERT_FALSE(remote.valid(ids[20]));
+  ASSERT_FALSE(remote.valid(ids[21]));
+  ASSERT_TRUE(remote.valid(recycled[0]));
+  ASSERT_EQ(remote.get<position>(recycled[0]).x, 7);
+  ASSERT_EQ(remote.query(yacs::registry::mask<health>()).size(), 25);
+
+  std::vector<yacs::entity_id> created;
+  remote.create(1, std::back_inserter(created));
+  world.create(1, std::back_inserter(created));
+  ASSERT_EQ(yacs::get_entity_index(created[0]),
+            yacs::get_entity_index(created[1]));
+}
+
+TEST_F(delta_test, rejects_bad_deltas) {
+  world.get<position>(ids[3]).x = 1000;
+  world.destroy(ids[5]);
+  yacs::delta::encode<position, health>(baseline, world, bytes);
+  ASSERT_FALSE(
+      yacs::delta::apply<position>(remote, bytes.data(), bytes.size()));
+  ASSERT_FALSE((yacs::delta::apply<position, health>(remote, bytes.data(),
+                                                     bytes.size() - 1)));
+
+  yacs::registry empty;
+  ASSERT_FALSE((yacs::delta::apply<position, health>(empty, bytes.data(),
+                                                     bytes.size())));
+  ASSERT_EQ(empty.storage<position>().size(), 0);
+}
+
+TEST_F(delta_test, rejects_dead_slots_and_unconsumed_streams) {
+  std::vector<uint8_t> stream;
+  yacs::xor_rle_encoder encoder(stream);
+  position value{3, 0};
+  encoder.push(reinterpret_cast<const uint8_t*>(&value), nullptr,
+               sizeof(value));
+  encoder.finish();
+  ASSERT_EQ(stream.size(), 3);
+  for (auto i : {7, 8, 10}) {
+    remote.destroy<position>(ids[i]);
+  }
+
+  remote.destroy(ids[9]);
+  bytes = position_delta(ids[9], stream);
+  ASSERT_FALSE(
+      yacs::delta::apply<position>(remote, bytes.data(), bytes.size()));
+
+  auto trailing = stream;
+  trailing.push_back(0);
+  bytes = position_delta(ids[7], trailing);
+  ASSERT_FALSE(
+      yacs::delta::apply<position>(remote, bytes.data(), bytes.size()));
+
+  // The last zero run reaches past the value.
+  auto long_run = stream;
+  long_run.back() += 8;
+  bytes = position_delta(ids[8], long_run);
+  ASSERT_FALSE(
+      yacs::delta::apply<position>(remote, bytes.data(), bytes.size()));
+
+  auto truncated = stream;
+  truncated.pop_back();
+  bytes = position_delta(ids[10], truncated);
+  ASSERT_FALSE(
+      yacs::delta::apply<position>(remote, bytes.data(), bytes.size()));
+  ASSERT_FALSE(remote.has<position>(ids[10]));
+
+  bytes = position_delta(ids[10], stream);
+  ASSERT_TRUE(
+      yacs::delta::apply<position>(remote, bytes.data(), bytes.size()));
+  ASSERT_EQ(remote.get<position>(ids[10]).x, 3);
+}
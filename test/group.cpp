@@ -0,0 +1,126 @@
+#include "group.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "entity.hpp"
+#include "registry.hpp"
+
+typedef struct position {
+  position(int x, int y) : x(x), y(y) {}
+  int x;
+  int y;
+} position;
+
+typedef struct velocity {
+  velocity(int dx, int dy) : dx(dx), dy(dy) {}
+  int dx;
+  int dy;
+} velocity;
+
+typedef struct mass {
+  mass(int m) : m(m) {}
+  int m;
+} mass;
+
+class group_test : public ::testing::Test {
+ protected:
+  void SetUp() {
+    for (int i = 0; i < 30; ++i) {
+      auto entity = registry.create();
+      ids.push_back(entity_id(i));
+      entity.add<position>(i, -i);
+      if (i % 2 == 0) {
+        entity.add<velocity>(2 * i, -2 * i);
+      }
+      if (i % 3 == 0) {
+        entity.add<mass>(i);
+      }
+    }
+  }
+
+  static yacs::entity_id entity_id(int index) {
+    return yacs::get_entity_id(index, 0);
+  }
+
+  size_t count(yacs::group<position, velocity>& group) {
+    size_t n = 0;
+    group.each([&](size_t index, position& p, velocity& v) {
+      EXPECT_EQ(p.x, static_cast<int>(index));
+      EXPECT_EQ(v.dx, 2 * p.x);
+      ++n;
+    });
+    return n;
+  }
+
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+};
+
+TEST_F(group_test, group_collects_existing_entities) {
+  auto group = registry.group<position, velocity>();
+  ASSERT_EQ(group.size(), 15);
+  ASSERT_EQ(count(group), 15);
+}
+
+TEST_F(group_test, group_is_shared) {
+  auto first = registry.group<position, velocity>();
+  auto second = registry.group<position, velocity>();
+  registry.add<velocity>(ids[1], 2, -2);
+  ASSERT_EQ(first.size(), 16);
+  ASSERT_EQ(second.size(), 16);
+}
+
+TEST_F(group_test, group_tracks_add) {
+  auto group = registry.group<position, velocity>();
+  for (int i = 1; i < 30; i += 2) {
+    registry.add<velocity>(ids[i], 2 * i, -2 * i);
+    ASSERT_TRUE(group.contains(i));
+  }
+  ASSERT_EQ(group.size(), 30);
+  ASSERT_EQ(count(group), 30);
+}
+
+TEST_F(group_test, group_tracks_component_destroy) {
+  auto group = registry.group<position, velocity>();
+  for (int i = 0; i < 30; i += 4) {
+    registry.destroy<velocity>(ids[i]);
+    ASSERT_FALSE(group.contains(i));
+  }
+  ASSERT_EQ(group.size(), 7);
+  ASSERT_EQ(count(group), 7);
+}
+
+TEST_F(group_test, group_tracks_entity_destroy) {
+  auto group = registry.group<position, velocity, mass>();
+  ASSERT_EQ(group.size(), 5);
+  registry.destroy(ids[0]);
+  registry.destroy(ids[12]);
+  ASSERT_EQ(group.size(), 3);
+  for (auto [p, v, m] : group) {
+    ASSERT_EQ(p.x % 6, 0);
+    ASSERT_EQ(v.dx, 2 * p.x);
+    ASSERT_EQ(m.m, p.x);
+  }
+}
+
+TEST_F(group_test, group_packs_owned_pools) {
+  auto group = registry.group<position, velocity>();
+  auto it = group.begin();
+  for (size_t i = 0; i < group.size(); ++i, ++it) {
+    auto [p, v] = *it;
+    ASSERT_EQ(p.x % 2, 0);
+    ASSERT_EQ(v.dx, 2 * p.x);
+  }
+  ASSERT_EQ(it, group.end());
+}
+
+TEST_F(group_test, group_mutable_iteration) {
+  auto group = registry.group<position, velocity>();
+  group.each([](position& p, velocity& v) { p.y += v.dy; });
+  registry.view<position>().each([](size_t index, position& p) {
+    int i = static_cast<int>(index);
+    ASSERT_EQ(p.y, i % 2 == 0 ? -3 * i : -i);
+  });
+}
@@ -0,0 +1,48 @@
+#include "hierarchical_bitset.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+TEST(hierarchical_bitset, set_reset_test) {
+  yacs::hierarchical_bitset bits;
+  bits.set(3);
+  bits.set(70000);
+  EXPECT_TRUE(bits.test(3));
+  EXPECT_TRUE(bits.test(70000));
+  EXPECT_FALSE(bits.test(4));
+  EXPECT_FALSE(bits.test(1 << 30));
+  EXPECT_EQ(bits.layers(), 3u);
+  EXPECT_NE(bits.word(2, 0), 0u);
+
+  bits.reset(70000);
+  EXPECT_FALSE(bits.test(70000));
+  EXPECT_EQ(bits.word(1, 70000 / 4096), 0u);
+  EXPECT_EQ(bits.word(2, 0), 1u);
+
+  bits.clear();
+  EXPECT_FALSE(bits.test(3));
+  EXPECT_EQ(bits.word(2, 0), 0u);
+}
+
+TEST(hierarchical_bitset, intersect_sets_of_different_heights) {
+  yacs::hierarchical_bitset small;
+  yacs::hierarchical_bitset large;
+  for (size_t i = 0; i < 64; i += 2) {
+    small.set(i);
+  }
+  for (size_t i = 0; i < 100000; i += 3) {
+    large.set(i);
+  }
+
+  std::vector<size_t> found;
+  std::array<const yacs::hierarchical_bitset*, 2> sets{&small, &large};
+  yacs::hierarchical_bitset::intersect(sets,
+                                       [&](size_t i) { found.push_back(i); });
+  std::vector<size_t> expected;
+  for (size_t i = 0; i < 64; i += 6) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(found, expected);
+}
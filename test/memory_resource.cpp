@@ -0,0 +1,147 @@
+#include "memory_resource.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+#include "observer.hpp"
+#include "pool.hpp"
+#include "registry.hpp"
+
+struct position {
+  int x;
+  int y;
+};
+
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  size_t allocations = 0;
+  size_t live = 0;
+
+ protected:
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    ++allocations;
+    live += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+    live -= bytes;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+TEST(memory_resource_test, registry_allocates_from_resource) {
+  counting_resource resource;
+  {
+    yacs::registry registry(&resource);
+    auto reserved = resource.live;
+    ASSERT_GT(reserved, 0);
+
+    std::vector<yacs::entity_id> ids;
+    registry.create(10000, std::back_inserter(ids));
+    for (int i = 0; i < 10000; ++i) {
+      registry.add<position>(ids[i], position{i, -i});
+    }
+    ASSERT_GT(resource.live, reserved);
+    ASSERT_EQ(registry.storage<position>().resource(), &resource);
+
+    // Signals and presence bits are allocated on first use.
+    {
+      yacs::observer observer(registry);
+      auto live = resource.live;
+      observer.on_construct<position>();
+      ASSERT_GT(resource.live, live);
+      live = resource.live;
+      registry.storage<position>().track_presence();
+      ASSERT_GT(resource.live, live);
+    }
+
+    yacs::registry moved(std::move(registry));
+    ASSERT_EQ(moved.resource(), &resource);
+    ASSERT_EQ(moved.get<position>(ids[42]).y, -42);
+  }
+  ASSERT_EQ(resource.live, 0);
+}
+
+TEST(memory_resource_test, registry_move_assign_across_resources) {
+  counting_resource first_resource, second_resource;
+  {
+    yacs::registry first(&first_resource);
+    yacs::registry second(&second_resource);
+    yacs::entity_id id;
+    first.create(1, &id);
+    first.add<position>(id, position{1, 2});
+    first.group<position>();
+    std::vector<yacs::entity_id> ids;
+    second.create(3, std::back_inserter(ids));
+
+    second = std::move(first);
+    ASSERT_EQ(second.resource(), &first_resource);
+    ASSERT_EQ(first.resource(), &second_resource);
+    ASSERT_EQ(second.get<position>(id).y, 2);
+    ASSERT_EQ(second.storage<position>().resource(), &first_resource);
+  }
+  ASSERT_EQ(first_resource.live, 0);
+  ASSERT_EQ(second_resource.live, 0);
+}
+
+TEST(memory_resource_test, pool_move_across_resources) {
+  counting_resource first_resource, second_resource;
+  yacs::packed_pool<position> first(&first_resource);
+  yacs::packed_pool<position> second(&second_resource);
+  for (int i = 0; i < 5000; i += 2) {
+    first.construct(i, position{i, i});
+  }
+  second = std::move(first);
+  ASSERT_EQ(second.resource(), &second_resource);
+  ASSERT_EQ(second.size(), 2500);
+  ASSERT_EQ(second[4998].x, 4998);
+  ASSERT_TRUE(first.empty());
+  ASSERT_FALSE(first.contains(4998));
+
+  yacs::packed_pool<position> copied(second);
+  ASSERT_EQ(copied.resource(), std::pmr::get_default_resource());
+  ASSERT_EQ(copied[10].y, 10);
+}
+
+TEST(memory_resource_test, huge_page_allocations) {
+  yacs::huge_page_resource resource;
+  auto bytes = yacs::HUGE_PAGE_SIZE + 4096;
+  auto* large = static_cast<char*>(resource.allocate(bytes, 64));
+#if !defined(_WIN32)
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(large) % yacs::HUGE_PAGE_SIZE, 0);
+#endif
+  std::memset(large, 1, bytes);
+  resource.deallocate(large, bytes, 64);
+
+  auto* small = resource.allocate(64, 16);
+  ASSERT_NE(small, nullptr);
+  resource.deallocate(small, 64, 16);
+}
+
+TEST(memory_resource_test, arena_backs_a_world) {
+  yacs::arena arena;
+  for (int run = 0; run < 3; ++run) {
+    {
+      yacs::registry registry(&arena);
+      std::vector<yacs::entity_id> ids;
+      registry.create(1000, std::back_inserter(ids));
+      for (int i = 0; i < 1000; ++i) {
+        registry.add<position>(ids[i], position{i, 1});
+      }
+      int sum = 0;
+      registry.view<position>().each([&sum](position& p) { sum += p.y; });
+      ASSERT_EQ(sum, 1000);
+    }
+    arena.release();
+  }
+}
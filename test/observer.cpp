@@ -0,0 +1,127 @@
+#include "observer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "entity.hpp"
+#include "registry.hpp"
+
+typedef struct position {
+  position(int x, int y) : x(x), y(y) {}
+  int x;
+  int y;
+} position;
+
+typedef struct velocity {
+  velocity(int dx, int dy) : dx(dx), dy(dy) {}
+  int dx;
+  int dy;
+} velocity;
+
+TEST(signal_test, publish_reaches_connected_listeners) {
+  yacs::signal<size_t> signal;
+  size_t sum = 0;
+  auto first = signal.connect([&](size_t value) { sum += value; });
+  signal.connect([&](size_t value) { sum += 10 * value; });
+  signal.publish(2);
+  ASSERT_EQ(sum, 22);
+
+  signal.disconnect(first);
+  signal.publish(1);
+  ASSERT_EQ(sum, 32);
+  ASSERT_EQ(signal.size(), 1);
+}
+
+TEST(pool_signal_test, construct_patch_replace_destroy) {
+  yacs::packed_pool<position> pool;
+  std::vector<size_t> constructed, updated, destroyed;
+  pool.on_construct().connect([&](size_t i) { constructed.push_back(i); });
+  pool.on_update().connect([&](size_t i) { updated.push_back(i); });
+  pool.on_destroy().connect([&](size_t i) {
+    ASSERT_TRUE(pool.contains(i));
+    destroyed.push_back(i);
+  });
+
+  pool.construct(3, 1, 2);
+  pool.construct(7, 3, 4);
+  pool.patch(3, [](position& p) { p.x = 10; });
+  pool.replace(7, 5, 6);
+  ASSERT_EQ(pool[3].x, 10);
+  ASSERT_EQ(pool[7].y, 6);
+
+  pool.destroy(3);
+  pool.destroy();
+
+  ASSERT_EQ(constructed, (std::vector<size_t>{3, 7}));
+  ASSERT_EQ(updated, (std::vector<size_t>{3, 7}));
+  ASSERT_EQ(destroyed, (std::vector<size_t>{3, 7}));
+}
+
+TEST(observer_test, collects_each_entity_once) {
+  yacs::registry registry;
+  yacs::observer observer(registry);
+  observer.on_construct<position>().on_update<position>();
+
+  std::vector<yacs::entity_id> ids;
+  registry.create(4, std::back_inserter(ids));
+  for (auto id : ids) {
+    registry.add<position>(id, 0, 0);
+  }
+  registry.add<velocity>(ids[0], 1, 1);
+  ASSERT_EQ(observer.size(), 4);
+
+  observer.clear();
+  registry.patch<position>(ids[1], [](position& p) { ++p.x; });
+  registry.patch<position>(ids[1], [](position& p) { ++p.x; });
+  registry.replace<position>(ids[3], 5, 5);
+  ASSERT_EQ(observer.size(), 2);
+  ASSERT_TRUE(observer.contains(ids[1]));
+  ASSERT_TRUE(observer.contains(ids[3]));
+  ASSERT_FALSE(observer.contains(ids[0]));
+  ASSERT_EQ(registry.get<position>(ids[1]).x, 2);
+
+  size_t count = 0;
+  observer.each([&](yacs::entity_id id) {
+    ASSERT_TRUE(registry.valid(id));
+    ++count;
+  });
+  ASSERT_EQ(count, 2);
+}
+
+TEST(observer_test, destroy_records_the_old_id) {
+  yacs::registry registry;
+  yacs::observer observer(registry);
+  observer.on_destroy<position>();
+
+  std::vector<yacs::entity_id> ids;
+  registry.create(3, std::back_inserter(ids));
+  for (auto id : ids) {
+    registry.add<position>(id, 0, 0);
+  }
+  registry.destroy<position>(ids[0]);
+  registry.destroy(ids[2]);
+
+  ASSERT_EQ(observer.size(), 2);
+  ASSERT_TRUE(observer.contains(ids[0]));
+  ASSERT_TRUE(observer.contains(ids[2]));
+  ASSERT_TRUE(registry.valid(ids[0]));
+  ASSERT_FALSE(registry.valid(ids[2]));
+}
+
+TEST(observer_test, disconnect_stops_collection) {
+  yacs::registry registry;
+  auto entity = registry.create();
+  {
+    yacs::observer observer(registry);
+    observer.on_construct<position>();
+    entity.add<position>(1, 1);
+    ASSERT_EQ(observer.size(), 1);
+    observer.disconnect();
+    entity.add<velocity>(1, 1);
+    entity.remove<position>();
+    entity.add<position>(2, 2);
+    ASSERT_EQ(observer.size(), 1);
+  }
+  ASSERT_TRUE(registry.on_construct<position>().empty());
+}
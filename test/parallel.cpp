@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "entity.hpp"
+#include "group.hpp"
+#include "pool.hpp"
+#include "registry.hpp"
+#include "thread_pool.hpp"
+#include "view.hpp"
+
+typedef struct position {
+  position(int x, int y) : x(x), y(y) {}
+  int x;
+  int y;
+} position;
+
+typedef struct velocity {
+  velocity(int dx, int dy) : dx(dx), dy(dy) {}
+  int dx;
+  int dy;
+} velocity;
+
+class serial_executor {
+ public:
+  size_t concurrency() const { return 4; }
+
+  template <typename Fn>
+  void parallel_for(size_t count, size_t grain, Fn&& fn) {
+    for (size_t begin = 0; begin < count; begin += grain) {
+      fn(begin, std::min(count, begin + grain));
+      ++chunks;
+    }
+  }
+
+  size_t chunks = 0;
+};
+
+TEST(thread_pool_test, parallel_for_covers_range) {
+  yacs::thread_pool pool(3);
+  std::vector<int> visited(100000, 0);
+  pool.parallel_for(visited.size(), 1000, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      visited[i] += 1;
+    }
+  });
+  for (auto count : visited) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+TEST(thread_pool_test, parallel_for_without_workers) {
+  yacs::thread_pool pool(0);
+  size_t total = 0;
+  pool.parallel_for(10, 3, [&](size_t begin, size_t end) {
+    total += end - begin;
+  });
+  ASSERT_EQ(total, 10);
+}
+
+TEST(thread_pool_test, nested_parallel_for) {
+  yacs::thread_pool pool(2);
+  std::atomic<size_t> total(0);
+  pool.parallel_for(8, 1, [&](size_t, size_t) {
+    pool.parallel_for(100, 10, [&](size_t begin, size_t end) {
+      total += end - begin;
+    });
+  });
+  ASSERT_EQ(total.load(), 800);
+}
+
+// Chunks outlast the caller's spin, so it has to sleep and be woken by the
+// last helper.
+TEST(thread_pool_test, parallel_for_wakes_sleeping_caller) {
+  yacs::thread_pool pool(2);
+  std::atomic<size_t> total(0);
+  for (int round = 0; round < 3; ++round) {
+    pool.parallel_for(3, 1, [&](size_t begin, size_t end) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20 * begin));
+      total += end - begin;
+    });
+  }
+  ASSERT_EQ(total.load(), 9);
+}
+
+TEST(thread_pool_test, chunk_size_is_cache_line_multiple) {
+  auto chunk = yacs::chunk_size<position>(1000000, 8);
+  ASSERT_EQ(chunk % (yacs::CACHE_LINE_SIZE / sizeof(position)), 0);
+  ASSERT_GE(chunk, 1000000 / 64);
+}
+
+TEST(parallel_each_test, pool_parallel_each) {
+  yacs::packed_pool<position> pool;
+  for (int i = 0; i < 50000; ++i) {
+    pool.construct(i, i, 0);
+  }
+  yacs::thread_pool executor(3);
+  pool.parallel_each([](size_t index, position& p) {
+    p.y = static_cast<int>(index) + p.x;
+  }, executor);
+  for (int i = 0; i < 50000; ++i) {
+    ASSERT_EQ(pool.access(i).y, 2 * i);
+  }
+}
+
+TEST(parallel_each_test, view_parallel_each) {
+  yacs::packed_pool<position> positions;
+  yacs::packed_pool<velocity> velocities;
+  for (int i = 0; i < 50000; ++i) {
+    positions.construct(i, i, 0);
+    if (i % 3 == 0) {
+      velocities.construct(i, 1, 2);
+    }
+  }
+  std::atomic<size_t> count(0);
+  yacs::view<position, const velocity> view(positions, velocities);
+  view.parallel_each([&](position& p, const velocity& v) {
+    p.x += v.dx;
+    p.y += v.dy;
+    ++count;
+  });
+  ASSERT_EQ(count.load(), velocities.size());
+  for (int i = 0; i < 50000; ++i) {
+    auto& p = positions.access(i);
+    ASSERT_EQ(p.x, i % 3 == 0 ? i + 1 : i);
+    ASSERT_EQ(p.y, i % 3 == 0 ? 2 : 0);
+  }
+}
+
+TEST(parallel_each_test, pluggable_executor) {
+  yacs::packed_pool<position> pool;
+  for (int i = 0; i < 10000; ++i) {
+    pool.construct(i, i, 0);
+  }
+  serial_executor executor;
+  size_t count = 0;
+  pool.parallel_each([&](position&) { ++count; }, executor);
+  ASSERT_EQ(count, pool.size());
+  ASSERT_GT(executor.chunks, 1);
+}
+
+TEST(parallel_each_test, group_parallel_each) {
+  yacs::registry registry;
+  for (int i = 0; i < 20000; ++i) {
+    auto entity = registry.create();
+    entity.add<position>(i, 0);
+    if (i % 2 == 0) {
+      entity.add<velocity>(1, 1);
+    }
+  }
+  auto group = registry.group<position, velocity>();
+  yacs::thread_pool executor(3);
+  group.parallel_each([](position& p, velocity& v) { p.y = p.x + v.dy; },
+                      executor);
+  registry.view<position>().each([](size_t index, position& p) {
+    ASSERT_EQ(p.y, index % 2 == 0 ? p.x + 1 : 0);
+  });
+}
+
+TEST(parallel_each_test, mutable_iteration_stamps_changed_ticks) {
+  yacs::registry registry;
+  registry.storage<position>().track_ticks();
+  registry.storage<velocity>().track_ticks();
+  for (int i = 0; i < 2000; ++i) {
+    auto entity = registry.create();
+    entity.add<position>(i, 0);
+    if (i % 2 == 0) {
+      entity.add<velocity>(1, 1);
+    }
+  }
+  auto group = registry.group<position, velocity>();
+  serial_executor executor;
+  auto changed = [&registry](yacs::pool::tick_type since) {
+    size_t count = 0;
+    registry.view<const position>().changed<position>(since).each(
+        [&count](const position&) { ++count; });
+    return count;
+  };
+
+  auto last_run = registry.tick();
+  registry.advance();
+  group.each([](position& p, velocity&) { ++p.y; });
+  ASSERT_EQ(changed(last_run), 1000);
+
+  last_run = registry.tick();
+  registry.advance();
+  group.parallel_each([](position& p, velocity&) { ++p.y; }, executor);
+  ASSERT_EQ(changed(last_run), 1000);
+
+  last_run = registry.tick();
+  registry.advance();
+  registry.storage<position>().parallel_each([](position& p) { ++p.y; },
+                                             executor);
+  ASSERT_EQ(changed(last_run), 2000);
+
+  last_run = registry.tick();
+  registry.advance();
+  for (auto& p : registry.storage<position>()) {
+    ++p.y;
+  }
+  ASSERT_EQ(changed(last_run), 2000);
+}
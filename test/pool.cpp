@@ -2,8 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "data_struct.hpp"
 
@@ -223,6 +227,60 @@ TEST_F(packed_pool_test, packed_pool_sort_comparator) {
   }
 }
 
+TEST_F(packed_pool_test, packed_pool_sort_by) {
+  yacs::packed_pool<data_struct> sorted;
+  for (int i = 0; i < 1000; ++i) {
+    sorted.construct(i, i, (i * 7919) % 1000 - 500);
+  }
+  sorted.sort_by([](const data_struct& value) { return value.y; });
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    ASSERT_EQ(sorted.raw()[i].y, static_cast<int>(i) - 500);
+    ASSERT_EQ(&sorted.access(sorted.data()[i]), sorted.raw() + i);
+  }
+
+  sorted.sort_by([](const data_struct& value) { return -0.5f * *value.x; });
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    ASSERT_EQ(sorted.sparse_index(i), 999 - i);
+  }
+
+  // Equal keys keep their relative order.
+  sorted.sort_by([](const data_struct& value) { return value.y < 0; });
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    bool previous = sorted.raw()[i - 1].y < 0;
+    bool current = sorted.raw()[i].y < 0;
+    ASSERT_LE(previous, current);
+    if (previous == current) {
+      ASSERT_GT(sorted.sparse_index(i - 1), sorted.sparse_index(i));
+    }
+  }
+}
+
+TEST_F(packed_pool_test, packed_pool_sort_nearly_sorted) {
+  yacs::packed_pool<data_struct> sorted;
+  sorted.track_ticks();
+  for (int i = 0; i < 1000; ++i) {
+    sorted.construct(i, i, 2 * i);
+  }
+  sorted.set_tick(2);
+  sorted.access(10).y = 1501;
+  sorted.access(900).y = -1;
+  sorted.destroy(500);
+  sorted.construct(1000, 1000, 999);
+  sorted.sort_by([](const data_struct& value) { return value.y; });
+
+  ASSERT_EQ(sorted.sparse_index(0), 900);
+  ASSERT_EQ(sorted.sparse_index(1), 0);
+  for (size_t i = 1; i < sorted.size(); ++i) {
+    ASSERT_LE(sorted.raw()[i - 1].y, sorted.raw()[i].y);
+  }
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    ASSERT_EQ(&sorted.access(sorted.data()[i]), sorted.raw() + i);
+    ASSERT_EQ(*sorted.raw()[i].x, static_cast<int>(sorted.data()[i]));
+  }
+  ASSERT_EQ(sorted.added_tick(1000), 2);
+  ASSERT_EQ(sorted.added_tick(999), 1);
+}
+
 TEST_F(packed_pool_test, packed_pool_sort_iterator) {
   vector<size_t> indices{5, 1, 3, 7, 2, 0, 9, 8, 4, 6};
   yacs::packed_pool<data_struct> ordered;
@@ -491,4 +549,146 @@ TEST_F(packed_pool_test, const_sparse_iterator_not_equal) {
   for (; it2 != pool.sparse_end(); ++it1, ++it2) {
     ASSERT_NE(it1, it2);
   }
-}
\ No newline at end of file
+}
+
+TEST_F(packed_pool_test, packed_pool_data_raw_parallel) {
+  pool.destroy(3);
+  pool.sort([](const data_struct& lhs, const data_struct& rhs) {
+    return lhs.y < rhs.y;
+  });
+  auto* indices = pool.data();
+  auto* values = pool.raw();
+  for (size_t i = 0; i < pool.size(); ++i) {
+    ASSERT_EQ(values[i], expected.access(indices[i]));
+    ASSERT_EQ(&pool.access(indices[i]), values + i);
+  }
+}
+
+TEST_F(packed_pool_test, packed_pool_sparse_pages) {
+  yacs::packed_pool<data_struct> paged;
+  std::vector<size_t> indices{10000000, 3, 10000001, 4096, 4095, 9999999};
+  for (auto index : indices) {
+    paged.construct(index, static_cast<int>(index), 0);
+  }
+  ASSERT_FALSE(paged.contains(0));
+  ASSERT_FALSE(paged.contains(5000000));
+  ASSERT_FALSE(paged.contains(20000000));
+  for (auto index : indices) {
+    ASSERT_TRUE(paged.contains(index));
+    ASSERT_EQ(*paged.access(index).x, static_cast<int>(index));
+  }
+  yacs::packed_pool<data_struct> copied(paged);
+  paged.destroy(10000000);
+  ASSERT_FALSE(paged.contains(10000000));
+  ASSERT_TRUE(copied.contains(10000000));
+  ASSERT_EQ(*paged.access(10000001).x, 10000001);
+  paged.sort();
+  auto it = paged.sparse_begin();
+  for (size_t index : {3, 4095, 4096, 9999999, 10000001}) {
+    ASSERT_EQ(*it++, index);
+    ASSERT_EQ(*paged.access(index).x, static_cast<int>(index));
+  }
+}
+
+TEST_F(packed_pool_test, packed_pool_ticks_follow_elements) {
+  pool.track_ticks();
+  ASSERT_EQ(pool.added_tick(3), 1);
+  pool.set_tick(2);
+  pool.construct(10, 10, -10);
+  pool.access(4);
+  std::as_const(pool).access(5);
+  pool.set_tick(3);
+  pool.patch(6, [](data_struct& value) { value.y = 0; });
+  pool.destroy(0);
+  pool.sort();
+
+  ASSERT_EQ(pool.added_tick(10), 2);
+  ASSERT_EQ(pool.changed_tick(10), 2);
+  ASSERT_EQ(pool.added_tick(4), 1);
+  ASSERT_EQ(pool.changed_tick(4), 2);
+  ASSERT_EQ(pool.changed_tick(5), 1);
+  ASSERT_EQ(pool.changed_tick(6), 3);
+  ASSERT_EQ(pool.changed_tick(9), 1);
+
+  yacs::packed_pool<data_struct> copied(pool);
+  ASSERT_TRUE(copied.tracks_ticks());
+  ASSERT_EQ(copied.changed_tick(6), 3);
+}
+
+struct tag {};
+
+TEST(packed_pool_tag_test, tag_pool_stores_membership_only) {
+  static_assert(yacs::is_tag_v<tag>);
+  static_assert(!yacs::is_tag_v<data_struct>);
+  yacs::packed_pool<tag> tags;
+  for (size_t index : {9, 3, 7, 1, 5}) {
+    tags.construct(index);
+  }
+  tags.destroy(7);
+  ASSERT_EQ(tags.size(), 4);
+  ASSERT_TRUE(tags.contains(5));
+  ASSERT_FALSE(tags.contains(7));
+  ASSERT_EQ(&tags.access(9), &tags.access(1));
+
+  tags.sort();
+  auto it = tags.sparse_begin();
+  for (size_t index : {1, 3, 5, 9}) {
+    ASSERT_EQ(*it++, index);
+  }
+  size_t count = 0;
+  for (auto& value : tags) {
+    static_cast<void>(value);
+    ++count;
+  }
+  ASSERT_EQ(count, 4);
+
+  yacs::packed_pool<tag> copied(tags);
+  tags.destroy(3);
+  ASSERT_FALSE(tags.contains(3));
+  ASSERT_TRUE(copied.contains(3));
+  ASSERT_EQ(copied.size(), 4);
+}
+
+// Moves a scattered subset, with one run of packed neighbours, out of a
+// pool of twenty and checks both sides stay consistent.
+template <typename T, typename Make>
+static void check_partial_transfer(Make make) {
+  yacs::packed_pool<T> source, target;
+  for (size_t i = 0; i < 20; ++i) {
+    source.construct(i, make(i));
+  }
+  target.construct(100, make(100));
+  std::vector<size_t> sources{17, 3, 4, 5, 19, 10};
+  std::vector<size_t> targets{200, 201, 202, 203, 204, 205};
+  source.transfer(target, sources.data(), targets.data(), sources.size());
+
+  ASSERT_EQ(source.size(), 14);
+  ASSERT_EQ(target.size(), 7);
+  ASSERT_EQ(target[100], make(100));
+  for (size_t i = 0; i < sources.size(); ++i) {
+    ASSERT_FALSE(source.contains(sources[i]));
+    ASSERT_EQ(target[targets[i]], make(sources[i]));
+  }
+  for (size_t i = 0; i < 20; ++i) {
+    auto moved = std::find(sources.begin(), sources.end(), i) != sources.end();
+    ASSERT_EQ(source.contains(i), !moved);
+    if (!moved) {
+      ASSERT_EQ(source[i], make(i));
+    }
+  }
+  for (size_t k = 0; k < source.size(); ++k) {
+    ASSERT_EQ(source.packed_index(source.data()[k]), k);
+  }
+  for (size_t k = 0; k < target.size(); ++k) {
+    ASSERT_EQ(target.packed_index(target.data()[k]), k);
+  }
+}
+
+TEST(packed_pool_transfer_test, partial_transfer_copies_trivial_values) {
+  check_partial_transfer<int>([](size_t i) { return static_cast<int>(i); });
+}
+
+TEST(packed_pool_transfer_test, partial_transfer_moves_values) {
+  check_partial_transfer<std::string>(
+      [](size_t i) { return "value " + std::to_string(i); });
+}
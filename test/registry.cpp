@@ -2,6 +2,10 @@
 
 #include <gtest/gtest.h>
 
+#include <iterator>
+#include <string>
+#include <vector>
+
 #include "entity.hpp"
 
 typedef struct position {
@@ -20,4 +24,271 @@ TEST(registry_test, basic_test) {
   // auto& p = entity.get<position>();
 
   registry.destroy(entity);
-}
\ No newline at end of file
+}
+
+TEST(registry_test, bulk_create_add_destroy) {
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+  registry.create(1000, std::back_inserter(ids));
+  ASSERT_EQ(ids.size(), 1000u);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    EXPECT_EQ(yacs::get_entity_index(ids[i]), i);
+    EXPECT_TRUE(registry.valid(ids[i]));
+  }
+
+  registry.add<position>(ids.begin(), ids.begin() + 500, position{1, 2});
+  registry.add<int>(ids.begin(), ids.end(), [](yacs::entity_id id) {
+    return static_cast<int>(yacs::get_entity_index(id));
+  });
+  EXPECT_EQ(registry.storage<position>().size(), 500u);
+  EXPECT_EQ(registry.get<position>(ids[499]).y, 2);
+  EXPECT_EQ(registry.get<int>(ids[700]), 700);
+
+  registry.destroy(ids.begin() + 250, ids.begin() + 750);
+  EXPECT_FALSE(registry.valid(ids[250]));
+  EXPECT_TRUE(registry.valid(ids[750]));
+  EXPECT_EQ(registry.storage<position>().size(), 250u);
+  EXPECT_EQ(registry.storage<int>().size(), 500u);
+
+  std::vector<yacs::entity_id> recycled;
+  registry.create(600, std::back_inserter(recycled));
+  EXPECT_EQ(recycled.size(), 600u);
+  EXPECT_EQ(yacs::get_entity_version(recycled.front()), 1u);
+  EXPECT_EQ(yacs::get_entity_version(recycled.back()), 0u);
+  EXPECT_EQ(yacs::get_entity_index(recycled.back()), 1099u);
+}
+
+TEST(registry_test, recycles_slots_after_sort) {
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+  registry.create(100, std::back_inserter(ids));
+  registry.destroy(ids[10]);
+  registry.destroy(ids.begin() + 20, ids.begin() + 23);
+  registry.add<position>(ids[50], position{1, 1});
+
+  // Sorting moves slots within the entity table.
+  registry.sort();
+
+  std::vector<yacs::entity_id> recycled;
+  registry.create(5, std::back_inserter(recycled));
+  std::vector<yacs::entity_index> expected{22, 21, 20, 10, 100};
+  for (size_t i = 0; i < recycled.size(); ++i) {
+    ASSERT_EQ(yacs::get_entity_index(recycled[i]), expected[i]);
+    ASSERT_EQ(yacs::get_entity_version(recycled[i]), i < 4 ? 1u : 0u);
+    ASSERT_TRUE(registry.valid(recycled[i]));
+  }
+  ASSERT_FALSE(registry.valid(ids[10]));
+
+  registry.destroy(recycled[2]);
+  registry.create(2, std::back_inserter(recycled));
+  ASSERT_EQ(recycled[5], yacs::get_entity_id(20, 2));
+  ASSERT_EQ(recycled[6], yacs::get_entity_id(101, 0));
+  ASSERT_EQ(registry.get<position>(ids[50]).x, 1);
+}
+
+TEST(registry_test, masks_track_add_and_remove) {
+  yacs::registry registry;
+  auto entity = registry.create();
+  auto id = yacs::get_entity_id(0, 0);
+  entity.add<position>();
+  registry.add<int>(id, 3);
+  EXPECT_EQ(registry.query(yacs::registry::mask<position, int>()).size(), 1u);
+
+  entity.remove<position>();
+  EXPECT_TRUE(registry.query(yacs::registry::mask<position>()).empty());
+  EXPECT_EQ(registry.query(yacs::registry::mask<int>()).size(), 1u);
+
+  registry.destroy(id);
+  EXPECT_TRUE(registry.query(yacs::registry::mask<int>()).empty());
+  EXPECT_EQ(registry.storage<int>().size(), 0u);
+}
+
+TEST(registry_test, query_include_exclude) {
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+  registry.create(101, std::back_inserter(ids));
+  for (size_t i = 0; i < ids.size(); ++i) {
+    if (i % 2 == 0) {
+      registry.add<position>(ids[i]);
+    }
+    if (i % 3 == 0) {
+      registry.add<int>(ids[i], 0);
+    }
+  }
+
+  auto both = registry.query(yacs::registry::mask<position, int>());
+  EXPECT_EQ(both.size(), 17u);
+  for (auto id : both) {
+    EXPECT_EQ(yacs::get_entity_index(id) % 6, 0u);
+  }
+
+  auto only_position = registry.query(yacs::registry::mask<position>(),
+                                      yacs::registry::mask<int>());
+  EXPECT_EQ(only_position.size(), 34u);
+  for (auto id : only_position) {
+    EXPECT_TRUE(registry.has<position>(id));
+    EXPECT_FALSE(registry.has<int>(id));
+  }
+}
+
+struct frozen {};
+
+TEST(registry_test, move_to_translates_ids) {
+  yacs::registry source, target;
+  std::vector<yacs::entity_id> ids;
+  source.create(100, std::back_inserter(ids));
+  for (int i = 0; i < 100; ++i) {
+    source.add<position>(ids[i], position{i, -i});
+    if (i % 2 == 0) {
+      source.add<std::string>(ids[i], std::to_string(i));
+    }
+    if (i % 5 == 0) {
+      source.add<frozen>(ids[i]);
+    }
+  }
+  target.create();
+
+  std::vector<yacs::entity_id> moving{ids[10], ids[3], ids[50]};
+  auto translation = source.move_to(target, moving.begin(), moving.end());
+  ASSERT_EQ(translation.size(), 3u);
+  for (size_t i = 0; i < moving.size(); ++i) {
+    auto old_id = translation[i].first;
+    auto new_id = translation[i].second;
+    auto n = static_cast<int>(yacs::get_entity_index(old_id));
+    ASSERT_EQ(old_id, moving[i]);
+    ASSERT_FALSE(source.valid(old_id));
+    ASSERT_TRUE(target.valid(new_id));
+    ASSERT_EQ(target.get<position>(new_id).y, -n);
+    ASSERT_EQ(target.has<std::string>(new_id), n % 2 == 0);
+    ASSERT_EQ(target.has<frozen>(new_id), n % 5 == 0);
+  }
+  ASSERT_EQ(target.get<std::string>(translation[0].second), "10");
+  ASSERT_EQ(source.storage<position>().size(), 97u);
+  ASSERT_EQ(source.storage<std::string>().size(), 48u);
+  ASSERT_EQ(source.get<std::string>(ids[98]), "98");
+  ASSERT_EQ(target.query(yacs::registry::mask<position, frozen>()).size(), 2u);
+  yacs::entity_id reused;
+  source.create(1, &reused);
+  ASSERT_EQ(reused, yacs::get_entity_id(50, 1));
+}
+
+TEST(registry_test, merge_moves_every_entity) {
+  yacs::registry source, target;
+  std::vector<yacs::entity_id> ids;
+  source.create(1000, std::back_inserter(ids));
+  source.add<position>(ids.begin(), ids.end(), [](yacs::entity_id id) {
+    auto n = static_cast<int>(yacs::get_entity_index(id));
+    return position{n, 2 * n};
+  });
+  source.destroy(ids[7]);
+  target.create(10, std::back_inserter(ids));
+  target.add<position>(ids[1000], position{-1, -1});
+
+  auto group = target.group<position>();
+  auto translation = target.merge(source);
+  ASSERT_EQ(translation.size(), 999u);
+  ASSERT_TRUE(source.storage<position>().empty());
+  ASSERT_EQ(target.storage<position>().size(), 1000u);
+  ASSERT_EQ(group.size(), 1000u);
+  for (auto& entry : translation) {
+    auto n = static_cast<int>(yacs::get_entity_index(entry.first));
+    ASSERT_NE(n, 7);
+    ASSERT_FALSE(source.valid(entry.first));
+    ASSERT_EQ(target.get<position>(entry.second).y, 2 * n);
+  }
+  ASSERT_EQ(target.get<position>(ids[1000]).x, -1);
+}
+
+TEST(registry_test, transfer_destroy_listeners_see_values) {
+  yacs::registry source, target;
+  std::vector<yacs::entity_id> ids;
+  source.create(10, std::back_inserter(ids));
+  for (int i = 0; i < 10; ++i) {
+    source.add<std::string>(ids[i], "value " + std::to_string(i));
+  }
+  std::vector<std::string> seen;
+  source.on_destroy<std::string>().connect(
+      [&](yacs::pool::index_type index) {
+        seen.push_back(source.storage<std::string>()[index]);
+      });
+
+  source.move_to(target, ids.begin(), ids.begin() + 2);
+  ASSERT_EQ(seen, (std::vector<std::string>{"value 0", "value 1"}));
+  target.merge(source);
+  ASSERT_EQ(seen.size(), 10u);
+  ASSERT_EQ(seen.back(), "value 9");
+  ASSERT_EQ(target.storage<std::string>().size(), 10u);
+}
+
+TEST(registry_test, bulk_destroy_batches_per_pool) {
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+  registry.create(100, std::back_inserter(ids));
+  registry.add<position>(ids.begin(), ids.end(), [](yacs::entity_id id) {
+    auto n = static_cast<int>(yacs::get_entity_index(id));
+    return position{n, n};
+  });
+  registry.add<int>(ids.begin(), ids.begin() + 50, 1);
+  auto group = registry.group<position, int>();
+  std::vector<int> seen;
+  registry.on_destroy<position>().connect([&](yacs::pool::index_type index) {
+    seen.push_back(registry.storage<position>()[index].x);
+  });
+
+  registry.destroy(ids.begin() + 40, ids.begin() + 60);
+  ASSERT_EQ(seen.size(), 20u);
+  ASSERT_EQ(seen.front(), 40);
+  ASSERT_EQ(seen.back(), 59);
+  ASSERT_EQ(group.size(), 40u);
+  ASSERT_EQ(registry.storage<position>().size(), 80u);
+  ASSERT_EQ(registry.storage<int>().size(), 40u);
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(registry.valid(ids[i]), i < 40 || i >= 60);
+  }
+  group.each([](position& p, int&) { ASSERT_LT(p.x, 40); });
+
+  registry.destroy(ids.begin(), ids.begin() + 40);
+  ASSERT_EQ(group.size(), 0u);
+  ASSERT_TRUE(registry.storage<int>().empty());
+}
+
+TEST(registry_test, double_destroy_keeps_free_list) {
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+  registry.create(4, std::back_inserter(ids));
+  registry.add<position>(ids[1], position{1, 1});
+  registry.destroy(ids[1]);
+  registry.destroy(ids[1]);
+  registry.destroy(ids.begin(), ids.begin() + 3);
+  registry.destroy(ids.begin() + 3, ids.end());
+  registry.destroy(ids[3]);
+
+  std::vector<yacs::entity_id> recycled;
+  registry.create(5, std::back_inserter(recycled));
+  std::vector<yacs::entity_index> indices;
+  for (auto id : recycled) {
+    ASSERT_TRUE(registry.valid(id));
+    ASSERT_FALSE(registry.has<position>(id));
+    indices.push_back(yacs::get_entity_index(id));
+  }
+  ASSERT_EQ(indices, (std::vector<yacs::entity_index>{3, 2, 0, 1, 4}));
+  ASSERT_EQ(yacs::get_entity_version(recycled[3]), 1u);
+}
+
+TEST(component_mask, wide_bits) {
+  yacs::component_mask mask;
+  mask.set(0).set(yacs::MAX_COMPONENTS - 1);
+  EXPECT_EQ(mask.count(), 2u);
+  EXPECT_TRUE(mask.test(yacs::MAX_COMPONENTS - 1));
+
+  std::vector<size_t> bits;
+  mask.each([&](size_t bit) { bits.push_back(bit); });
+  EXPECT_EQ(bits, (std::vector<size_t>{0, yacs::MAX_COMPONENTS - 1}));
+
+  yacs::component_mask low;
+  low.set(5);
+  EXPECT_TRUE(low < mask);
+  EXPECT_FALSE(mask.includes(low));
+  mask.reset(yacs::MAX_COMPONENTS - 1);
+  EXPECT_FALSE(mask.intersects(low));
+}
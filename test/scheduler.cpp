@@ -0,0 +1,219 @@
+#include "scheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+#include "entity.hpp"
+
+typedef struct position {
+  int x;
+} position;
+
+typedef struct velocity {
+  int dx;
+} velocity;
+
+typedef struct health {
+  int hp;
+} health;
+
+class scheduler_test : public ::testing::Test {
+ protected:
+  void record(int id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(id);
+  }
+
+  size_t position_of(int id) {
+    for (size_t i = 0; i < order.size(); ++i) {
+      if (order[i] == id) {
+        return i;
+      }
+    }
+    return order.size();
+  }
+
+  yacs::registry registry;
+  yacs::thread_pool executor{4};
+  std::mutex mutex;
+  std::vector<int> order;
+};
+
+TEST_F(scheduler_test, runs_every_system) {
+  yacs::scheduler scheduler(registry, executor);
+  std::atomic<int> runs(0);
+  for (int i = 0; i < 10; ++i) {
+    scheduler.add("system", yacs::reads<position>(), yacs::writes<>(),
+                  [&](yacs::registry&) { ++runs; });
+  }
+  scheduler.run();
+  scheduler.run();
+  ASSERT_EQ(runs.load(), 20);
+}
+
+TEST_F(scheduler_test, readers_do_not_depend_on_each_other) {
+  yacs::scheduler scheduler(registry, executor);
+  scheduler.add("a", yacs::reads<position>(), yacs::writes<velocity>(),
+                [](yacs::registry&) {});
+  scheduler.add("b", yacs::reads<position>(), yacs::writes<health>(),
+                [](yacs::registry&) {});
+  scheduler.run();
+  ASSERT_TRUE(scheduler.dependencies()[0].empty());
+}
+
+TEST_F(scheduler_test, conflicting_systems_keep_declaration_order) {
+  yacs::scheduler scheduler(registry, executor);
+  scheduler.add("write position", yacs::reads<>(), yacs::writes<position>(),
+                [&](yacs::registry&) { record(0); });
+  scheduler.add("read position", yacs::reads<position>(),
+                yacs::writes<velocity>(), [&](yacs::registry&) { record(1); });
+  scheduler.add("write velocity", yacs::reads<>(), yacs::writes<velocity>(),
+                [&](yacs::registry&) { record(2); });
+  scheduler.add("independent", yacs::reads<health>(), yacs::writes<>(),
+                [&](yacs::registry&) { record(3); });
+  scheduler.run();
+  ASSERT_EQ(scheduler.dependencies(),
+            (std::vector<std::vector<size_t>>{{1}, {2}, {}, {}}));
+  ASSERT_EQ(order.size(), 4);
+  ASSERT_LT(position_of(0), position_of(1));
+  ASSERT_LT(position_of(1), position_of(2));
+}
+
+// Each system waits at a latch for the other, so both can only get past it
+// if they run at the same time. The wait is bounded so that a serial
+// schedule fails instead of hanging.
+TEST_F(scheduler_test, disjoint_systems_run_concurrently) {
+  yacs::scheduler scheduler(registry, executor);
+  std::condition_variable arrived;
+  int waiting = 2;
+  std::atomic<int> met(0);
+  auto system = [&](yacs::registry&) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (--waiting == 0) {
+      arrived.notify_all();
+    }
+    if (arrived.wait_for(lock, std::chrono::seconds(30),
+                         [&] { return waiting == 0; })) {
+      ++met;
+    }
+  };
+  scheduler.add("a", yacs::reads<>(), yacs::writes<position>(), system);
+  scheduler.add("b", yacs::reads<>(), yacs::writes<velocity>(), system);
+  scheduler.run();
+  ASSERT_TRUE(scheduler.dependencies()[0].empty());
+  ASSERT_EQ(met.load(), 2);
+}
+
+TEST_F(scheduler_test, exclusive_system_is_a_barrier) {
+  yacs::scheduler scheduler(registry, executor);
+  scheduler.add("a", yacs::reads<>(), yacs::writes<position>(),
+                [&](yacs::registry&) { record(0); });
+  scheduler.add_exclusive("spawn", [&](yacs::registry& r) {
+    auto entity = r.create();
+    entity.add<health>(health{10});
+    record(1);
+  });
+  scheduler.add("b", yacs::reads<>(), yacs::writes<velocity>(),
+                [&](yacs::registry&) { record(2); });
+  scheduler.run();
+  ASSERT_EQ(order, (std::vector<int>{0, 1, 2}));
+  ASSERT_EQ(registry.storage<health>().size(), 1);
+}
+
+TEST_F(scheduler_test, systems_access_components) {
+  for (int i = 0; i < 100; ++i) {
+    auto entity = registry.create();
+    entity.add<position>(position{i});
+    entity.add<velocity>(velocity{1});
+    entity.add<health>(health{i});
+  }
+  yacs::scheduler scheduler(registry, executor);
+  scheduler.add("move", yacs::reads<velocity>(), yacs::writes<position>(),
+                [](yacs::registry& r) {
+                  r.view<position, const velocity>().each(
+                      [](position& p, const velocity& v) { p.x += v.dx; });
+                });
+  scheduler.add("heal", yacs::reads<>(), yacs::writes<health>(),
+                [](yacs::registry& r) {
+                  r.view<health>().each([](health& h) { h.hp += 1; });
+                });
+  scheduler.run();
+  registry.view<position, health>().each([](position& p, health& h) {
+    ASSERT_EQ(p.x, h.hp);
+  });
+}
+
+// The watcher runs between two writers in every frame. It must see writes
+// from the system before it in the same frame and from the one after it in
+// the previous frame, each exactly once.
+TEST_F(scheduler_test, changed_filter_sees_writes_within_a_frame) {
+  registry.storage<position>().track_ticks();
+  std::vector<yacs::entity_id> ids;
+  registry.create(10, std::back_inserter(ids));
+  registry.add<position>(ids.begin(), ids.end(), position{0});
+
+  std::vector<size_t> early, late;
+  size_t seen = 0;
+  yacs::scheduler scheduler(registry, executor);
+  scheduler.add("early", yacs::reads<>(), yacs::writes<position>(),
+                [&](yacs::registry& r) {
+                  for (auto i : early) {
+                    ++r.get<position>(ids[i]).x;
+                  }
+                });
+  scheduler.add("watch", yacs::reads<position>(), yacs::writes<>(),
+                [&](yacs::registry& r, yacs::scheduler::tick_type last_run) {
+                  seen = 0;
+                  r.view<const position>().changed<position>(last_run).each(
+                      [&](const position&) { ++seen; });
+                });
+  scheduler.add("late", yacs::reads<>(), yacs::writes<position>(),
+                [&](yacs::registry& r) {
+                  for (auto i : late) {
+                    ++r.get<position>(ids[i]).x;
+                  }
+                });
+
+  scheduler.run();
+  ASSERT_EQ(seen, 10u);
+
+  early = {0, 1, 2};
+  late = {9};
+  scheduler.run();
+  ASSERT_EQ(seen, 3u);
+
+  early.clear();
+  late.clear();
+  scheduler.run();
+  ASSERT_EQ(seen, 1u);
+
+  scheduler.run();
+  ASSERT_EQ(seen, 0u);
+
+  ++registry.get<position>(ids[5]).x;
+  scheduler.run();
+  ASSERT_EQ(seen, 1u);
+}
+
+TEST(scheduler_death_test, registering_during_parallel_systems_asserts) {
+  EXPECT_DEBUG_DEATH(
+      {
+        yacs::registry registry;
+        yacs::thread_pool executor(1);
+        yacs::scheduler scheduler(registry, executor);
+        yacs::entity_id id;
+        registry.create(1, &id);
+        scheduler.add("spawn", yacs::reads<>(), yacs::writes<position>(),
+                      [id](yacs::registry& r) {
+                        r.add<health>(id, health{1});
+                      });
+        scheduler.run();
+      },
+      "registered while parallel systems run");
+}
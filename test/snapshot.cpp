@@ -0,0 +1,189 @@
+#include "snapshot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "registry.hpp"
+
+struct position {
+  int x;
+  int y;
+};
+
+struct name {
+  std::string value;
+};
+
+template <>
+struct yacs::serializer<name> {
+  static void write(snapshot_writer& out, const name& component) {
+    out.write(static_cast<uint32_t>(component.value.size()));
+    out.write(component.value.data(), component.value.size());
+  }
+
+  static name read(snapshot_reader& in) {
+    std::string value(in.read<uint32_t>(), '\0');
+    in.read(value.data(), value.size());
+    return name{value};
+  }
+};
+
+class snapshot_test : public ::testing::Test {
+ protected:
+  void SetUp() {
+    path = ::testing::TempDir() + "yacs_snapshot.bin";
+    registry.create(100, std::back_inserter(ids));
+    for (int i = 0; i < 100; ++i) {
+      registry.add<position>(ids[i], position{i, -i});
+      if (i % 3 == 0) {
+        registry.add<name>(ids[i], name{"entity " + std::to_string(i)});
+      }
+    }
+    registry.destroy(ids[10]);
+    registry.destroy(ids[20]);
+  }
+
+  std::string path;
+  yacs::registry registry;
+  std::vector<yacs::entity_id> ids;
+};
+
+TEST_F(snapshot_test, round_trip) {
+  ASSERT_TRUE((yacs::snapshot::save<position, name>(registry, path.c_str())));
+
+  yacs::registry loaded;
+  ASSERT_TRUE((yacs::snapshot::load<position, name>(loaded, path.c_str())));
+  ASSERT_EQ(loaded.storage<position>().size(), 98);
+  ASSERT_EQ(loaded.storage<name>().size(), 34);
+  for (int i = 0; i < 100; ++i) {
+    if (i == 10 || i == 20) {
+      ASSERT_FALSE(loaded.valid(ids[i]));
+      continue;
+    }
+    ASSERT_TRUE(loaded.valid(ids[i]));
+    ASSERT_EQ(loaded.get<position>(ids[i]).x, i);
+    ASSERT_EQ(loaded.has<name>(ids[i]), i % 3 == 0);
+    if (i % 3 == 0) {
+      ASSERT_EQ(loaded.get<name>(ids[i]).value, "entity " + std::to_string(i));
+    }
+  }
+  ASSERT_EQ(loaded.query(yacs::registry::mask<position, name>()).size(), 34);
+
+  std::vector<yacs::entity_id> reused;
+  loaded.create(2, std::back_inserter(reused));
+  for (auto id : reused) {
+    ASSERT_EQ(yacs::get_entity_version(id), 1);
+  }
+}
+
+TEST_F(snapshot_test, skips_unlisted_components) {
+  ASSERT_TRUE(yacs::snapshot::save<position>(registry, path.c_str()));
+  yacs::registry loaded;
+  ASSERT_TRUE((yacs::snapshot::load<position, name>(loaded, path.c_str())));
+  ASSERT_EQ(loaded.storage<position>().size(), 98);
+  ASSERT_FALSE(loaded.has<name>(ids[0]));
+}
+
+TEST_F(snapshot_test, rejects_bad_files) {
+  yacs::registry loaded;
+  ASSERT_FALSE(yacs::snapshot::load<position>(loaded, "/nonexistent/file"));
+
+  ASSERT_TRUE(yacs::snapshot::save<position>(registry, path.c_str()));
+  {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(0);
+    file.write("NOTASNAP", 8);
+  }
+  ASSERT_FALSE(yacs::snapshot::load<position>(loaded, path.c_str()));
+}
+
+TEST_F(snapshot_test, rejects_bad_pool_indices) {
+  ASSERT_TRUE(yacs::snapshot::save<position>(registry, path.c_str()));
+  yacs::snapshot_section section;
+  {
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(sizeof(yacs::snapshot_header) + sizeof(section));
+    file.read(reinterpret_cast<char*>(&section), sizeof(section));
+  }
+  auto corrupt = [&](yacs::pool::index_type index) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(static_cast<std::streamoff>(section.indices +
+                                           sizeof(yacs::pool::index_type)));
+    file.write(reinterpret_cast<const char*>(&index), sizeof(index));
+  };
+  yacs::registry loaded;
+
+  corrupt(yacs::get_entity_index(ids[0]));
+  ASSERT_FALSE(yacs::snapshot::load<position>(loaded, path.c_str()));
+  corrupt(yacs::get_entity_index(ids[10]));
+  ASSERT_FALSE(yacs::snapshot::load<position>(loaded, path.c_str()));
+  corrupt(1000000);
+  ASSERT_FALSE(yacs::snapshot::load<position>(loaded, path.c_str()));
+  corrupt(yacs::get_entity_index(ids[1]));
+  ASSERT_TRUE(yacs::snapshot::load<position>(loaded, path.c_str()));
+}
+
+TEST_F(snapshot_test, rejects_overflowing_and_misaligned_sections) {
+  ASSERT_TRUE(yacs::snapshot::save<position>(registry, path.c_str()));
+  auto section_offset = static_cast<std::streamoff>(
+      sizeof(yacs::snapshot_header) + sizeof(yacs::snapshot_section));
+  yacs::snapshot_section section;
+  {
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(section_offset);
+    file.read(reinterpret_cast<char*>(&section), sizeof(section));
+  }
+  auto patch = [&](const yacs::snapshot_section& patched) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(section_offset);
+    file.write(reinterpret_cast<const char*>(&patched), sizeof(patched));
+  };
+
+  yacs::registry loaded;
+  yacs::entity_id kept;
+  loaded.create(1, &kept);
+  loaded.add<position>(kept, position{7, 7});
+
+  // Both count * 8 products wrap back to the saved sizes, so multiplied
+  // bounds would pass.
+  auto overflow = section;
+  overflow.count += uint64_t(1) << 61;
+  patch(overflow);
+  ASSERT_FALSE(yacs::snapshot::load<position>(loaded, path.c_str()));
+
+  auto misaligned = section;
+  misaligned.values += 1;
+  patch(misaligned);
+  ASSERT_FALSE(yacs::snapshot::load<position>(loaded, path.c_str()));
+
+  // A failed load leaves the registry it was given untouched.
+  ASSERT_EQ(loaded.storage<position>().size(), 1u);
+  ASSERT_EQ(loaded.get<position>(kept).x, 7);
+
+  patch(section);
+  ASSERT_TRUE(yacs::snapshot::load<position>(loaded, path.c_str()));
+  ASSERT_EQ(loaded.storage<position>().size(), 98u);
+}
+
+struct selected {};
+
+TEST_F(snapshot_test, tag_sections_hold_indices_only) {
+  for (int i = 0; i < 100; i += 7) {
+    if (registry.valid(ids[i])) {
+      registry.add<selected>(ids[i]);
+    }
+  }
+  ASSERT_TRUE(
+      (yacs::snapshot::save<position, selected>(registry, path.c_str())));
+  yacs::registry loaded;
+  ASSERT_TRUE(
+      (yacs::snapshot::load<position, selected>(loaded, path.c_str())));
+  ASSERT_EQ(loaded.storage<selected>().size(), 15);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(loaded.has<selected>(ids[i]), i % 7 == 0);
+  }
+}
@@ -0,0 +1,54 @@
+#include "types.hpp"
+
+#include <gtest/gtest.h>
+
+#include "entity.hpp"
+#include "registry.hpp"
+
+typedef struct pinned {
+  int value;
+} pinned;
+
+typedef struct dynamic {
+  int value;
+} dynamic;
+
+YACS_COMPONENT(pinned, 2)
+
+static_assert(yacs::component_traits<pinned>::id() == 2,
+              "pinned ids are compile-time constants");
+static_assert(yacs::component_traits<pinned>::hash ==
+                  yacs::hash_name(yacs::type_name<pinned>()),
+              "hashes are compile-time constants");
+
+TEST(component_traits, static_and_dynamic_ids) {
+  EXPECT_GE(yacs::component_traits<dynamic>::id(), yacs::STATIC_COMPONENTS);
+  EXPECT_GE(yacs::component_traits<int>::id(), yacs::STATIC_COMPONENTS);
+  EXPECT_NE(yacs::component_traits<dynamic>::id(),
+            yacs::component_traits<int>::id());
+
+  yacs::registry registry;
+  auto entity = registry.create();
+  entity.add<pinned>().value = 7;
+  entity.add<dynamic>().value = 8;
+  EXPECT_EQ(entity.get<pinned>().value, 7);
+  EXPECT_EQ(registry.query(yacs::registry::mask<pinned, dynamic>()).size(), 1u);
+}
+
+TEST(component_traits, too_many_components_aborts) {
+  auto next = yacs::g_component_id_counter;
+  yacs::g_component_id_counter = yacs::MAX_COMPONENTS - 1;
+  EXPECT_EQ(yacs::next_component_id(), yacs::MAX_COMPONENTS - 1);
+  EXPECT_DEATH(yacs::next_component_id(), "raise YACS_MAX_COMPONENTS");
+  yacs::g_component_id_counter = next;
+}
+
+TEST(component_traits, hash_follows_type_name) {
+  EXPECT_NE(yacs::type_name<dynamic>().find("dynamic"), std::string_view::npos);
+  EXPECT_EQ(yacs::component_traits<dynamic>::hash,
+            yacs::hash_name(yacs::type_name<dynamic>()));
+  EXPECT_NE(yacs::component_traits<dynamic>::hash,
+            yacs::component_traits<pinned>::hash);
+  EXPECT_NE(yacs::component_traits<int>::hash,
+            yacs::component_traits<unsigned>::hash);
+}
@@ -0,0 +1,245 @@
+#include "view.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "data_struct.hpp"
+#include "entity.hpp"
+#include "registry.hpp"
+
+typedef struct position {
+  position(int x, int y) : x(x), y(y) {}
+  int x;
+  int y;
+} position;
+
+typedef struct velocity {
+  velocity(int dx, int dy) : dx(dx), dy(dy) {}
+  int dx;
+  int dy;
+} velocity;
+
+struct frozen {};
+
+class view_test : public ::testing::Test {
+ protected:
+  void SetUp() {
+    for (int i = 0; i < 100; ++i) {
+      positions.construct(i, i, -i);
+      if (i % 2 == 0) {
+        velocities.construct(i, 2 * i, -2 * i);
+      }
+      if (i % 5 == 0) {
+        masses.construct(i, i);
+      }
+      if (i % 3 == 0) {
+        frozens.construct(i);
+      }
+    }
+  }
+
+  yacs::packed_pool<position> positions;
+  yacs::packed_pool<velocity> velocities;
+  yacs::packed_pool<int> masses;
+  yacs::packed_pool<frozen> frozens;
+};
+
+TEST_F(view_test, view_single_component) {
+  yacs::view<position> view(positions);
+  size_t count = 0;
+  view.each([&](position& p) {
+    ASSERT_EQ(p.x, -p.y);
+    ++count;
+  });
+  ASSERT_EQ(count, positions.size());
+}
+
+TEST_F(view_test, view_each_joins_components) {
+  yacs::view<position, velocity> view(positions, velocities);
+  size_t count = 0;
+  view.each([&](position& p, velocity& v) {
+    ASSERT_EQ(v.dx, 2 * p.x);
+    ASSERT_EQ(v.dy, 2 * p.y);
+    ++count;
+  });
+  ASSERT_EQ(count, velocities.size());
+}
+
+TEST_F(view_test, view_each_with_index) {
+  yacs::view<position, velocity, int> view(positions, velocities, masses);
+  size_t count = 0;
+  view.each([&](size_t index, position& p, velocity& v, int& m) {
+    ASSERT_EQ(index % 10, 0);
+    ASSERT_EQ(p.x, static_cast<int>(index));
+    ASSERT_EQ(v.dx, 2 * p.x);
+    ASSERT_EQ(m, p.x);
+    ++count;
+  });
+  ASSERT_EQ(count, 10);
+}
+
+TEST_F(view_test, view_each_mutates_components) {
+  yacs::view<position, const velocity> view(positions, velocities);
+  view.each([](position& p, const velocity& v) {
+    p.x += v.dx;
+    p.y += v.dy;
+  });
+  for (int i = 0; i < 100; ++i) {
+    auto& p = positions.access(i);
+    ASSERT_EQ(p.x, i % 2 == 0 ? 3 * i : i);
+    ASSERT_EQ(p.y, i % 2 == 0 ? -3 * i : -i);
+  }
+}
+
+TEST_F(view_test, view_driven_by_smallest_pool) {
+  yacs::view<position, velocity, int> view(positions, velocities, masses);
+  ASSERT_EQ(view.size_hint(), masses.size());
+}
+
+TEST_F(view_test, view_range_for) {
+  yacs::view<position, velocity> view(positions, velocities);
+  size_t count = 0;
+  for (auto [p, v] : view) {
+    ASSERT_EQ(v.dx, 2 * p.x);
+    p.x = 0;
+    ++count;
+  }
+  ASSERT_EQ(count, velocities.size());
+  for (int i = 0; i < 100; i += 2) {
+    ASSERT_EQ(positions.access(i).x, 0);
+  }
+}
+
+TEST_F(view_test, view_iterator_skips_missing) {
+  yacs::view<velocity, int> view(velocities, masses);
+  auto it = view.begin();
+  for (size_t expected = 0; expected < 100; expected += 10, ++it) {
+    ASSERT_NE(it, view.end());
+    ASSERT_EQ(it.index(), expected);
+  }
+  ASSERT_EQ(it, view.end());
+}
+
+TEST_F(view_test, view_empty_pool) {
+  yacs::packed_pool<data_struct> empty;
+  yacs::view<position, data_struct> view(positions, empty);
+  ASSERT_EQ(view.begin(), view.end());
+  view.each([](position&, data_struct&) { FAIL(); });
+}
+
+TEST_F(view_test, view_contains_and_get) {
+  yacs::view<position, velocity> view(positions, velocities);
+  ASSERT_TRUE(view.contains(4));
+  ASSERT_FALSE(view.contains(5));
+  auto [p, v] = view.get(4);
+  ASSERT_EQ(p.x, 4);
+  ASSERT_EQ(v.dx, 8);
+}
+
+TEST(registry_view_test, registry_view) {
+  yacs::registry registry;
+  for (int i = 0; i < 10; ++i) {
+    auto entity = registry.create();
+    entity.add<position>(i, i);
+    if (i % 3 == 0) {
+      entity.add<velocity>(1, 1);
+    }
+  }
+  size_t count = 0;
+  registry.view<position, const velocity>().each(
+      [&](position& p, const velocity& v) {
+        p.x += v.dx;
+        ++count;
+      });
+  ASSERT_EQ(count, 4);
+}
+
+TEST_F(view_test, view_each_intersects_presence_bitsets) {
+  positions.track_presence();
+  velocities.track_presence();
+  masses.track_presence();
+  velocities.destroy(20);
+  masses.construct(1000, 1000);
+  velocities.construct(1000, 0, 0);
+  positions.construct(1000, 1000, -1000);
+
+  yacs::view<position, velocity, int> view(positions, velocities, masses);
+  ASSERT_TRUE(view.tracks_presence());
+  std::vector<size_t> visited;
+  view.each([&](size_t index, position& p, velocity&, int& m) {
+    ASSERT_EQ(p.x, static_cast<int>(index));
+    ASSERT_EQ(m, p.x);
+    visited.push_back(index);
+  });
+  ASSERT_EQ(visited,
+            (std::vector<size_t>{0, 10, 30, 40, 50, 60, 70, 80, 90, 1000}));
+}
+
+TEST(registry_view_test, registry_view_change_ticks) {
+  yacs::registry registry;
+  registry.storage<position>().track_ticks();
+  registry.storage<velocity>().track_ticks();
+  std::vector<yacs::entity_id> ids;
+  registry.create(10, std::back_inserter(ids));
+  registry.add<position>(ids.begin(), ids.end(), position(0, 0));
+  registry.add<velocity>(ids.begin(), ids.end(), velocity(1, 1));
+
+  auto last_run = registry.tick();
+  registry.advance();
+  registry.patch<position>(ids[2], [](position& p) { p.x = 2; });
+  registry.get<position>(ids[7]).x = 7;
+  registry.create(1, std::back_inserter(ids));
+  registry.add<position>(ids.back(), 9, 9);
+
+  size_t count = 0;
+  registry.view<const position, const velocity>().each(
+      [&](const position&, const velocity&) { ++count; });
+  ASSERT_EQ(count, 10);
+
+  std::vector<int> changed;
+  registry.view<const position>().changed<position>(last_run).each(
+      [&](const position& p) { changed.push_back(p.x); });
+  std::sort(changed.begin(), changed.end());
+  ASSERT_EQ(changed, (std::vector<int>{2, 7, 9}));
+
+  count = 0;
+  registry.view<const position>().added<position>(last_run).each(
+      [&](const position& p) {
+        ASSERT_EQ(p.x, 9);
+        ++count;
+      });
+  ASSERT_EQ(count, 1);
+
+  last_run = registry.tick();
+  registry.advance();
+  registry.view<position, const velocity>().each(
+      [](position& p, const velocity& v) { p.x += v.dx; });
+  count = 0;
+  registry.view<const position, const velocity>()
+      .changed<velocity>(last_run)
+      .each([&](const position&, const velocity&) { ++count; });
+  ASSERT_EQ(count, 0);
+  auto view = registry.view<const position>().changed<position>(last_run);
+  ASSERT_EQ(std::distance(view.begin(), view.end()), 10);
+}
+
+TEST_F(view_test, view_with_tag_component) {
+  std::vector<size_t> visited;
+  yacs::view<frozen, int> driven(frozens, masses);
+  driven.each([&](size_t index, frozen&, int& m) {
+    ASSERT_EQ(m, static_cast<int>(index));
+    visited.push_back(index);
+  });
+  ASSERT_EQ(visited, (std::vector<size_t>{0, 15, 30, 45, 60, 75, 90}));
+
+  size_t count = 0;
+  yacs::view<position, frozen> joined(positions, frozens);
+  joined.each([&](position& p, frozen&) {
+    ASSERT_EQ(p.x % 3, 0);
+    ++count;
+  });
+  ASSERT_EQ(count, 34);
+}